@@ -11,22 +11,66 @@
 //
 
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
 #include "easing.h"
 
+// sin(pi * x) for |x| < 2^22, branch free so curves using it still
+// vectorize. x is reduced to r in [-0.5, 0.5] around the nearest integer k,
+// then sin(pi * r) is a degree 9 minimax polynomial (error below 7e-9
+// before float rounding) with the sign flipped for odd k
+static inline AHFloat EaseSinPi(AHFloat x)
+{
+	const int32_t k = (int32_t)(x + (x < 0 ? -0.5f : 0.5f));
+	const AHFloat r = x - (AHFloat)k;
+	const AHFloat s = r * r;
+	const AHFloat y =
+		r * (3.14159264f +
+		     s * (-5.16771009f +
+			  s * (2.55007766f +
+			       s * (-0.598292160f + s * 0.0776594083f))));
+	return (k & 1) ? -y : y;
+}
+
+// 2^x, branch free like EaseSinPi. x is clamped to the normal float range,
+// 2^floor(x) goes straight into the exponent bits and 2^fraction is a
+// degree 6 minimax polynomial (relative error below 3e-9 before float
+// rounding)
+static inline AHFloat EaseExp2(AHFloat x)
+{
+	x = x < -126.0f ? -126.0f : (x > 127.0f ? 127.0f : x);
+	const int32_t k = (int32_t)(x + 128.0f) - 128;
+	const AHFloat f = x - (AHFloat)k;
+	const AHFloat y =
+		1.0f +
+		f * (0.693146925f +
+		     f * (0.240230550f +
+			  f * (0.0554802210f +
+			       f * (0.00968497632f +
+				    f * (0.00123843035f +
+					 f * 0.000218892290f)))));
+	union {
+		int32_t i;
+		AHFloat f;
+	} scale;
+	scale.i = (k + 127) << 23;
+	return y * scale.f;
+}
+
 // Modeled after the line y = x
-AHFloat LinearInterpolation(AHFloat p)
+inline AHFloat LinearInterpolation(AHFloat p)
 {
 	return p;
 }
 
 // Modeled after the parabola y = x^2
-AHFloat QuadraticEaseIn(AHFloat p)
+inline AHFloat QuadraticEaseIn(AHFloat p)
 {
 	return p * p;
 }
 
 // Modeled after the parabola y = -x^2 + 2x
-AHFloat QuadraticEaseOut(AHFloat p)
+inline AHFloat QuadraticEaseOut(AHFloat p)
 {
 	return -(p * (p - 2));
 }
@@ -34,9 +78,9 @@ AHFloat QuadraticEaseOut(AHFloat p)
 // Modeled after the piecewise quadratic
 // y = (1/2)((2x)^2)             ; [0, 0.5)
 // y = -(1/2)((2x-1)*(2x-3) - 1) ; [0.5, 1]
-AHFloat QuadraticEaseInOut(AHFloat p)
+inline AHFloat QuadraticEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
+	if (p < 0.5f) {
 		return 2 * p * p;
 	} else {
 		return (-2 * p * p) + (4 * p) - 1;
@@ -44,13 +88,13 @@ AHFloat QuadraticEaseInOut(AHFloat p)
 }
 
 // Modeled after the cubic y = x^3
-AHFloat CubicEaseIn(AHFloat p)
+inline AHFloat CubicEaseIn(AHFloat p)
 {
 	return p * p * p;
 }
 
 // Modeled after the cubic y = (x - 1)^3 + 1
-AHFloat CubicEaseOut(AHFloat p)
+inline AHFloat CubicEaseOut(AHFloat p)
 {
 	AHFloat f = (p - 1);
 	return f * f * f + 1;
@@ -59,24 +103,24 @@ AHFloat CubicEaseOut(AHFloat p)
 // Modeled after the piecewise cubic
 // y = (1/2)((2x)^3)       ; [0, 0.5)
 // y = (1/2)((2x-2)^3 + 2) ; [0.5, 1]
-AHFloat CubicEaseInOut(AHFloat p)
+inline AHFloat CubicEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
+	if (p < 0.5f) {
 		return 4 * p * p * p;
 	} else {
 		AHFloat f = ((2 * p) - 2);
-		return 0.5 * f * f * f + 1;
+		return 0.5f * f * f * f + 1;
 	}
 }
 
 // Modeled after the quartic x^4
-AHFloat QuarticEaseIn(AHFloat p)
+inline AHFloat QuarticEaseIn(AHFloat p)
 {
 	return p * p * p * p;
 }
 
 // Modeled after the quartic y = 1 - (x - 1)^4
-AHFloat QuarticEaseOut(AHFloat p)
+inline AHFloat QuarticEaseOut(AHFloat p)
 {
 	AHFloat f = (p - 1);
 	return f * f * f * (1 - p) + 1;
@@ -85,9 +129,9 @@ AHFloat QuarticEaseOut(AHFloat p)
 // Modeled after the piecewise quartic
 // y = (1/2)((2x)^4)        ; [0, 0.5)
 // y = -(1/2)((2x-2)^4 - 2) ; [0.5, 1]
-AHFloat QuarticEaseInOut(AHFloat p)
+inline AHFloat QuarticEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
+	if (p < 0.5f) {
 		return 8 * p * p * p * p;
 	} else {
 		AHFloat f = (p - 1);
@@ -96,13 +140,13 @@ AHFloat QuarticEaseInOut(AHFloat p)
 }
 
 // Modeled after the quintic y = x^5
-AHFloat QuinticEaseIn(AHFloat p)
+inline AHFloat QuinticEaseIn(AHFloat p)
 {
 	return p * p * p * p * p;
 }
 
 // Modeled after the quintic y = (x - 1)^5 + 1
-AHFloat QuinticEaseOut(AHFloat p)
+inline AHFloat QuinticEaseOut(AHFloat p)
 {
 	AHFloat f = (p - 1);
 	return f * f * f * f * f + 1;
@@ -111,163 +155,220 @@ AHFloat QuinticEaseOut(AHFloat p)
 // Modeled after the piecewise quintic
 // y = (1/2)((2x)^5)       ; [0, 0.5)
 // y = (1/2)((2x-2)^5 + 2) ; [0.5, 1]
-AHFloat QuinticEaseInOut(AHFloat p)
+inline AHFloat QuinticEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
+	if (p < 0.5f) {
 		return 16 * p * p * p * p * p;
 	} else {
 		AHFloat f = ((2 * p) - 2);
-		return 0.5 * f * f * f * f * f + 1;
+		return 0.5f * f * f * f * f * f + 1;
 	}
 }
 
 // Modeled after quarter-cycle of sine wave
-AHFloat SineEaseIn(AHFloat p)
+inline AHFloat SineEaseIn(AHFloat p)
 {
-	return sin((p - 1) * M_PI_2) + 1;
+	return EaseSinPi((p - 1) * 0.5f) + 1;
 }
 
 // Modeled after quarter-cycle of sine wave (different phase)
-AHFloat SineEaseOut(AHFloat p)
+inline AHFloat SineEaseOut(AHFloat p)
 {
-	return sin(p * M_PI_2);
+	return EaseSinPi(p * 0.5f);
 }
 
 // Modeled after half sine wave
-AHFloat SineEaseInOut(AHFloat p)
+inline AHFloat SineEaseInOut(AHFloat p)
 {
-	return 0.5 * (1 - cos(p * M_PI));
+	return 0.5f * (1 - EaseSinPi(0.5f - p));
 }
 
 // Modeled after shifted quadrant IV of unit circle
-AHFloat CircularEaseIn(AHFloat p)
+inline AHFloat CircularEaseIn(AHFloat p)
 {
-	return 1 - sqrt(1 - (p * p));
+	return 1 - sqrtf(1 - (p * p));
 }
 
 // Modeled after shifted quadrant II of unit circle
-AHFloat CircularEaseOut(AHFloat p)
+inline AHFloat CircularEaseOut(AHFloat p)
 {
-	return sqrt((2 - p) * p);
+	return sqrtf((2 - p) * p);
 }
 
 // Modeled after the piecewise circular function
 // y = (1/2)(1 - sqrt(1 - 4x^2))           ; [0, 0.5)
 // y = (1/2)(sqrt(-(2x - 3)*(2x - 1)) + 1) ; [0.5, 1]
-AHFloat CircularEaseInOut(AHFloat p)
+inline AHFloat CircularEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
-		return 0.5 * (1 - sqrt(1 - 4 * (p * p)));
+	if (p < 0.5f) {
+		return 0.5f * (1 - sqrtf(1 - 4 * (p * p)));
 	} else {
-		return 0.5 * (sqrt(-((2 * p) - 3) * ((2 * p) - 1)) + 1);
+		return 0.5f * (sqrtf(-((2 * p) - 3) * ((2 * p) - 1)) + 1);
 	}
 }
 
 // Modeled after the exponential function y = 2^(10(x - 1))
-AHFloat ExponentialEaseIn(AHFloat p)
+inline AHFloat ExponentialEaseIn(AHFloat p)
 {
-	return (p == 0.0) ? p : pow(2, 10 * (p - 1));
+	return (p == 0.0f) ? p : EaseExp2(10 * (p - 1));
 }
 
 // Modeled after the exponential function y = -2^(-10x) + 1
-AHFloat ExponentialEaseOut(AHFloat p)
+inline AHFloat ExponentialEaseOut(AHFloat p)
 {
-	return (p == 1.0) ? p : 1 - pow(2, -10 * p);
+	return (p == 1.0f) ? p : 1 - EaseExp2(-10 * p);
 }
 
 // Modeled after the piecewise exponential
 // y = (1/2)2^(10(2x - 1))         ; [0,0.5)
 // y = -(1/2)*2^(-10(2x - 1))) + 1 ; [0.5,1]
-AHFloat ExponentialEaseInOut(AHFloat p)
+inline AHFloat ExponentialEaseInOut(AHFloat p)
 {
-	if (p == 0.0 || p == 1.0)
+	if (p == 0.0f || p == 1.0f)
 		return p;
 
-	if (p < 0.5) {
-		return 0.5 * pow(2, (20 * p) - 10);
+	if (p < 0.5f) {
+		return 0.5f * EaseExp2((20 * p) - 10);
 	} else {
-		return -0.5 * pow(2, (-20 * p) + 10) + 1;
+		return -0.5f * EaseExp2((-20 * p) + 10) + 1;
 	}
 }
 
 // Modeled after the damped sine wave y = sin(13pi/2*x)*pow(2, 10 * (x - 1))
-AHFloat ElasticEaseIn(AHFloat p)
+inline AHFloat ElasticEaseIn(AHFloat p)
 {
-	return sin(13 * M_PI_2 * p) * pow(2, 10 * (p - 1));
+	return EaseSinPi(6.5f * p) * EaseExp2(10 * (p - 1));
 }
 
 // Modeled after the damped sine wave y = sin(-13pi/2*(x + 1))*pow(2, -10x) + 1
-AHFloat ElasticEaseOut(AHFloat p)
+inline AHFloat ElasticEaseOut(AHFloat p)
 {
-	return sin(-13 * M_PI_2 * (p + 1)) * pow(2, -10 * p) + 1;
+	return EaseSinPi(-6.5f * (p + 1)) * EaseExp2(-10 * p) + 1;
 }
 
 // Modeled after the piecewise exponentially-damped sine wave:
 // y = (1/2)*sin(13pi/2*(2*x))*pow(2, 10 * ((2*x) - 1))      ; [0,0.5)
 // y = (1/2)*(sin(-13pi/2*((2x-1)+1))*pow(2,-10(2*x-1)) + 2) ; [0.5, 1]
-AHFloat ElasticEaseInOut(AHFloat p)
+inline AHFloat ElasticEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
-		return 0.5 * sin(13 * M_PI_2 * (2 * p)) *
-		       pow(2, 10 * ((2 * p) - 1));
+	if (p < 0.5f) {
+		return 0.5f * EaseSinPi(6.5f * (2 * p)) *
+		       EaseExp2(10 * ((2 * p) - 1));
 	} else {
-		return 0.5 * (sin(-13 * M_PI_2 * ((2 * p - 1) + 1)) *
-				      pow(2, -10 * (2 * p - 1)) +
+		return 0.5f * (EaseSinPi(-6.5f * ((2 * p - 1) + 1)) *
+				      EaseExp2(-10 * (2 * p - 1)) +
 			      2);
 	}
 }
 
 // Modeled after the overshooting cubic y = x^3-x*sin(x*pi)
-AHFloat BackEaseIn(AHFloat p)
+inline AHFloat BackEaseIn(AHFloat p)
 {
-	return p * p * p - p * sin(p * M_PI);
+	return p * p * p - p * EaseSinPi(p);
 }
 
 // Modeled after overshooting cubic y = 1-((1-x)^3-(1-x)*sin((1-x)*pi))
-AHFloat BackEaseOut(AHFloat p)
+inline AHFloat BackEaseOut(AHFloat p)
 {
 	AHFloat f = (1 - p);
-	return 1 - (f * f * f - f * sin(f * M_PI));
+	return 1 - (f * f * f - f * EaseSinPi(f));
 }
 
 // Modeled after the piecewise overshooting cubic function:
 // y = (1/2)*((2x)^3-(2x)*sin(2*x*pi))           ; [0, 0.5)
 // y = (1/2)*(1-((1-x)^3-(1-x)*sin((1-x)*pi))+1) ; [0.5, 1]
-AHFloat BackEaseInOut(AHFloat p)
+inline AHFloat BackEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
+	if (p < 0.5f) {
 		AHFloat f = 2 * p;
-		return 0.5 * (f * f * f - f * sin(f * M_PI));
+		return 0.5f * (f * f * f - f * EaseSinPi(f));
 	} else {
 		AHFloat f = (1 - (2 * p - 1));
-		return 0.5 * (1 - (f * f * f - f * sin(f * M_PI))) + 0.5;
+		return 0.5f * (1 - (f * f * f - f * EaseSinPi(f))) + 0.5f;
 	}
 }
 
-AHFloat BounceEaseIn(AHFloat p)
+inline AHFloat BounceEaseIn(AHFloat p)
 {
 	return 1 - BounceEaseOut(1 - p);
 }
 
-AHFloat BounceEaseOut(AHFloat p)
+// Piecewise parabolas written around their vertices, as expanded
+// polynomials they cancel too much in single precision
+inline AHFloat BounceEaseOut(AHFloat p)
 {
-	if (p < 4 / 11.0) {
-		return (121 * p * p) / 16.0;
-	} else if (p < 8 / 11.0) {
-		return (363 / 40.0 * p * p) - (99 / 10.0 * p) + 17 / 5.0;
-	} else if (p < 9 / 10.0) {
-		return (4356 / 361.0 * p * p) - (35442 / 1805.0 * p) +
-		       16061 / 1805.0;
+	if (p < 4 / 11.0f) {
+		return (121 / 16.0f) * p * p;
+	} else if (p < 8 / 11.0f) {
+		AHFloat f = p - 6 / 11.0f;
+		return (363 / 40.0f) * f * f + 0.7f;
+	} else if (p < 9 / 10.0f) {
+		AHFloat f = p - 179 / 220.0f;
+		return (4356 / 361.0f) * f * f + 0.91f;
 	} else {
-		return (54 / 5.0 * p * p) - (513 / 25.0 * p) + 268 / 25.0;
+		AHFloat f = p - 0.95f;
+		return (54 / 5.0f) * f * f + 0.973f;
 	}
 }
 
-AHFloat BounceEaseInOut(AHFloat p)
+inline AHFloat BounceEaseInOut(AHFloat p)
 {
-	if (p < 0.5) {
-		return 0.5 * BounceEaseIn(p * 2);
+	if (p < 0.5f) {
+		return 0.5f * BounceEaseIn(p * 2);
 	} else {
-		return 0.5 * BounceEaseOut(p * 2 - 1) + 0.5;
+		return 0.5f * BounceEaseOut(p * 2 - 1) + 0.5f;
+	}
+}
+
+// Every known curve gets its own loop with the curve inlined into it instead
+// of an indirect call per value. The curves are all arithmetic, selects and
+// sqrtf, so with easing.c built without errno and trapping math (see
+// CMakeLists.txt) each loop vectorizes
+#define EASE_BATCH_CASE(f)                     \
+	if (function == f) {                   \
+		for (size_t i = 0; i < n; i++) \
+			out[i] = f(p[i]);      \
+		return;                        \
+	}
+
+void EaseBatch(AHEasingFunction function, const AHFloat *p, AHFloat *out,
+	       size_t n)
+{
+	if (!function || function == LinearInterpolation) {
+		if (out != p)
+			memmove(out, p, n * sizeof(AHFloat));
+		return;
 	}
+	EASE_BATCH_CASE(QuadraticEaseIn)
+	EASE_BATCH_CASE(QuadraticEaseOut)
+	EASE_BATCH_CASE(QuadraticEaseInOut)
+	EASE_BATCH_CASE(CubicEaseIn)
+	EASE_BATCH_CASE(CubicEaseOut)
+	EASE_BATCH_CASE(CubicEaseInOut)
+	EASE_BATCH_CASE(QuarticEaseIn)
+	EASE_BATCH_CASE(QuarticEaseOut)
+	EASE_BATCH_CASE(QuarticEaseInOut)
+	EASE_BATCH_CASE(QuinticEaseIn)
+	EASE_BATCH_CASE(QuinticEaseOut)
+	EASE_BATCH_CASE(QuinticEaseInOut)
+	EASE_BATCH_CASE(SineEaseIn)
+	EASE_BATCH_CASE(SineEaseOut)
+	EASE_BATCH_CASE(SineEaseInOut)
+	EASE_BATCH_CASE(CircularEaseIn)
+	EASE_BATCH_CASE(CircularEaseOut)
+	EASE_BATCH_CASE(CircularEaseInOut)
+	EASE_BATCH_CASE(ExponentialEaseIn)
+	EASE_BATCH_CASE(ExponentialEaseOut)
+	EASE_BATCH_CASE(ExponentialEaseInOut)
+	EASE_BATCH_CASE(ElasticEaseIn)
+	EASE_BATCH_CASE(ElasticEaseOut)
+	EASE_BATCH_CASE(ElasticEaseInOut)
+	EASE_BATCH_CASE(BackEaseIn)
+	EASE_BATCH_CASE(BackEaseOut)
+	EASE_BATCH_CASE(BackEaseInOut)
+	EASE_BATCH_CASE(BounceEaseIn)
+	EASE_BATCH_CASE(BounceEaseOut)
+	EASE_BATCH_CASE(BounceEaseInOut)
+	for (size_t i = 0; i < n; i++)
+		out[i] = function(p[i]);
 }
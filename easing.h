@@ -24,6 +24,8 @@
 #endif
 typedef AH_FLOAT_TYPE AHFloat;
 
+#include <stddef.h>
+
 #if defined __cplusplus
 extern "C" {
 #endif
@@ -37,6 +39,10 @@ extern "C" {
 
 typedef AHFloat (*AHEasingFunction)(AHFloat);
 
+// Applies an easing function to n values, out may be the same array as p
+void EaseBatch(AHEasingFunction function, const AHFloat *p, AHFloat *out,
+	       size_t n);
+
 // Linear interpolation (no easing)
 AHFloat LinearInterpolation(AHFloat p);
 
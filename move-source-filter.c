@@ -2,64 +2,217 @@
 #include <obs-module.h>
 #include <stdio.h>
 #include <util/dstr.h>
+#include <util/threading.h>
 
-struct move_source_info {
-	obs_source_t *source;
-	char *source_name;
-	char *filter_name;
-	obs_sceneitem_t *scene_item;
-	obs_hotkey_id move_start_hotkey;
-
-	long long easing;
-	long long easing_function;
-	float curve;
-
-	struct vec2 pos_from;
-	struct vec2 pos_to;
-	float rot_from;
-	float rot_to;
-	struct vec2 scale_from;
-	struct vec2 scale_to;
-	struct vec2 bounds_from;
-	struct vec2 bounds_to;
-	struct obs_sceneitem_crop crop_from;
-	struct obs_sceneitem_crop crop_to;
-	uint64_t duration;
-	uint64_t start_delay;
-	uint64_t end_delay;
-	bool moving;
-	float running_duration;
-	uint32_t canvas_width;
-	uint32_t canvas_height;
-	uint32_t start_trigger;
-	bool enabled;
-	char *next_move_name;
-	bool relative;
-	DARRAY(obs_source_t *) filters_done;
-
-	long long next_move_on;
-	long long change_visibility;
-	bool visibility_toggled;
-	bool reverse;
-
-	long long change_order;
-	int order_position;
+// name to scene item lookup shared by every move source filter on a scene,
+// rebuilt on the first lookup after the items of the scene changed
+struct scene_item_names {
+	struct match_index index;
+	DARRAY(char *) names;
 };
 
-bool find_sceneitem(obs_scene_t *scene, obs_sceneitem_t *scene_item, void *data)
+struct scene_item_index {
+	obs_scene_t *scene;
+	long refs;
+	long generation;
+	long built_generation;
+	bool built;
+	struct scene_item_names names;
+};
+
+static pthread_mutex_t scene_item_indexes_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DARRAY(struct scene_item_index *) scene_item_indexes;
+
+static void scene_item_names_free(struct scene_item_names *names)
+{
+	match_index_free(&names->index);
+	for (size_t i = 0; i < names->names.num; i++)
+		bfree(names->names.array[i]);
+	da_free(names->names);
+}
+
+static bool scene_item_names_add(obs_scene_t *scene, obs_sceneitem_t *item,
+				 void *data)
 {
 	UNUSED_PARAMETER(scene);
-	struct move_source_info *move_source = data;
-	const char *name =
-		obs_source_get_name(obs_sceneitem_get_source(scene_item));
-	if (name && strcmp(name, move_source->source_name) == 0) {
-		obs_sceneitem_addref(scene_item);
-		move_source->scene_item = scene_item;
-		return false;
-	}
+	struct scene_item_names *names = data;
+	const char *name = obs_source_get_name(obs_sceneitem_get_source(item));
+	if (!name)
+		return true;
+	char *copy = bstrdup(name);
+	da_push_back(names->names, &copy);
+	match_index_add(&names->index, copy, item);
 	return true;
 }
 
+static void scene_item_index_changed(void *data, calldata_t *call_data)
+{
+	UNUSED_PARAMETER(call_data);
+	struct scene_item_index *index = data;
+	// taking the lock waits for a lookup that may still use the item
+	pthread_mutex_lock(&scene_item_indexes_mutex);
+	index->generation++;
+	pthread_mutex_unlock(&scene_item_indexes_mutex);
+}
+
+struct scene_item_find {
+	struct match_index *index;
+	const char *name;
+	obs_sceneitem_t *item;
+};
+
+static void scene_item_find_cb(void *param, size_t i, void *data)
+{
+	struct scene_item_find *find = param;
+	// hash matches, the first item in scene order wins
+	if (!find->item &&
+	    strcmp(find->index->entries.array[i].name, find->name) == 0)
+		find->item = data;
+}
+
+// renames are global, only a source with an item in this scene matters
+static void scene_item_index_rename(void *data, const char *prev_name,
+				    const char *new_name)
+{
+	UNUSED_PARAMETER(new_name);
+	struct scene_item_index *index = data;
+	pthread_mutex_lock(&scene_item_indexes_mutex);
+	// a stale index may be rebuilding from names read before the rename
+	bool changed = !prev_name || !index->built ||
+		       index->built_generation != index->generation;
+	if (!changed) {
+		struct scene_item_find find = {&index->names.index, prev_name,
+					       NULL};
+		match_index_enum_exact(&index->names.index, prev_name,
+				       scene_item_find_cb, &find);
+		changed = find.item != NULL;
+	}
+	if (changed)
+		index->generation++;
+	pthread_mutex_unlock(&scene_item_indexes_mutex);
+}
+
+static const char *scene_item_index_signals[] = {
+	"item_add",
+	"item_remove",
+	"reorder",
+	"refresh",
+};
+
+static void scene_item_index_connect(struct scene_item_index *index,
+				     bool connect)
+{
+	obs_source_t *scene_source = obs_scene_get_source(index->scene);
+	signal_handler_t *sh = obs_source_get_signal_handler(scene_source);
+	const size_t count = sizeof(scene_item_index_signals) /
+			     sizeof(scene_item_index_signals[0]);
+	for (size_t i = 0; i < count; i++) {
+		if (connect)
+			signal_handler_connect(sh, scene_item_index_signals[i],
+					       scene_item_index_changed, index);
+		else
+			signal_handler_disconnect(sh,
+						  scene_item_index_signals[i],
+						  scene_item_index_changed,
+						  index);
+	}
+	if (connect)
+		move_rename_subscribe(index, NULL, scene_item_index_rename);
+	else
+		move_rename_unsubscribe(index);
+}
+
+static struct scene_item_index *scene_item_index_acquire(obs_scene_t *scene)
+{
+	struct scene_item_index *index = NULL;
+	pthread_mutex_lock(&scene_item_indexes_mutex);
+	for (size_t i = 0; i < scene_item_indexes.num; i++) {
+		if (scene_item_indexes.array[i]->scene == scene) {
+			index = scene_item_indexes.array[i];
+			index->refs++;
+			break;
+		}
+	}
+	const bool created = !index;
+	if (created) {
+		index = bzalloc(sizeof(struct scene_item_index));
+		index->scene = scene;
+		index->refs = 1;
+		match_index_init(&index->names.index);
+		da_push_back(scene_item_indexes, &index);
+	}
+	pthread_mutex_unlock(&scene_item_indexes_mutex);
+	// signal callbacks run under the signal lock, connect outside ours
+	if (created)
+		scene_item_index_connect(index, true);
+	return index;
+}
+
+static void scene_item_index_release(struct scene_item_index *index)
+{
+	if (!index)
+		return;
+	pthread_mutex_lock(&scene_item_indexes_mutex);
+	const bool destroy = --index->refs == 0;
+	if (destroy)
+		da_erase_item(scene_item_indexes, &index);
+	pthread_mutex_unlock(&scene_item_indexes_mutex);
+	if (!destroy)
+		return;
+	scene_item_index_connect(index, false);
+	scene_item_names_free(&index->names);
+	bfree(index);
+}
+
+static obs_sceneitem_t *scene_item_index_find(struct scene_item_index *index,
+					      const char *name)
+{
+	pthread_mutex_lock(&scene_item_indexes_mutex);
+	while (!index->built || index->built_generation != index->generation) {
+		const long generation = index->generation;
+		pthread_mutex_unlock(&scene_item_indexes_mutex);
+
+		// enumerating locks the scene, so build outside our lock
+		struct scene_item_names names = {0};
+		match_index_init(&names.index);
+		obs_scene_enum_items(index->scene, scene_item_names_add,
+				     &names);
+
+		pthread_mutex_lock(&scene_item_indexes_mutex);
+		if (generation == index->generation) {
+			scene_item_names_free(&index->names);
+			index->names = names;
+			index->built_generation = generation;
+			index->built = true;
+		} else {
+			scene_item_names_free(&names);
+		}
+	}
+	struct scene_item_find find = {&index->names.index, name, NULL};
+	match_index_enum_exact(&index->names.index, name, scene_item_find_cb,
+			       &find);
+	if (find.item)
+		obs_sceneitem_addref(find.item);
+	pthread_mutex_unlock(&scene_item_indexes_mutex);
+	return find.item;
+}
+
+static void move_source_find_sceneitem(struct move_source_info *move_source,
+				       obs_scene_t *scene)
+{
+	if (move_source->item_index &&
+	    move_source->item_index->scene != scene) {
+		scene_item_index_release(move_source->item_index);
+		move_source->item_index = NULL;
+	}
+	if (!move_source->item_index)
+		move_source->item_index = scene_item_index_acquire(scene);
+	move_source->scene_item = scene_item_index_find(
+		move_source->item_index, move_source->source_name);
+	if (move_source->scene_item)
+		move_chains_invalidate();
+}
+
 void calc_relative_to(struct move_source_info *move_source, float f)
 {
 	obs_data_t *settings = obs_source_get_settings(move_source->source);
@@ -90,6 +243,8 @@ void calc_relative_to(struct move_source_info *move_source, float f)
 	obs_data_release(settings);
 }
 
+bool move_source_tick(void *data, float seconds);
+
 void move_source_start(struct move_source_info *move_source)
 {
 	if (!move_source->scene_item && move_source->source_name &&
@@ -99,8 +254,7 @@ void move_source_start(struct move_source_info *move_source)
 		if (parent) {
 			obs_scene_t *scene = obs_scene_from_source(parent);
 			if (scene)
-				obs_scene_enum_items(scene, find_sceneitem,
-						     move_source);
+				move_source_find_sceneitem(move_source, scene);
 		}
 	}
 	if (!move_source->scene_item)
@@ -179,6 +333,8 @@ void move_source_start(struct move_source_info *move_source)
 	     !move_source->visibility_toggled) ||
 	    move_source->visibility_toggled) {
 		move_source->moving = true;
+		move_animation_queue(move_source->source, move_source,
+				     move_source_tick);
 	} else if (move_source->start_trigger == START_TRIGGER_ENABLE_DISABLE) {
 		obs_source_set_enabled(move_source->source, false);
 	}
@@ -208,89 +364,7 @@ void move_source_start_hotkey(void *data, obs_hotkey_id id,
 		move_source_start(move_source);
 		return;
 	}
-	if (!move_source->filters_done.num) {
-		move_source_start(move_source);
-		da_push_back(move_source->filters_done, &move_source->source);
-		return;
-	}
-
-	char *next_move_name = move_source->next_move_name;
-	obs_source_t *filter = move_source->source;
-	obs_source_t *parent = obs_filter_get_parent(filter);
-	obs_source_t *source =
-		obs_sceneitem_get_source(move_source->scene_item);
-	long long next_move_on = move_source->next_move_on;
-	size_t i = 0;
-	while (i < move_source->filters_done.num) {
-		if (!next_move_name || !strlen(next_move_name)) {
-			move_source_start(move_source);
-			move_source->filters_done.num = 0;
-			da_push_back(move_source->filters_done,
-				     &move_source->source);
-			return;
-		}
-		if (next_move_on != NEXT_MOVE_ON_HOTKEY) {
-			da_push_back(move_source->filters_done, &filter);
-		}
-		filter = obs_source_get_filter_by_name(parent, next_move_name);
-		if (!filter && source) {
-			filter = obs_source_get_filter_by_name(source,
-							       next_move_name);
-		}
-
-		if (filter && strcmp(obs_source_get_unversioned_id(filter),
-				     MOVE_SOURCE_FILTER_ID) == 0) {
-			struct move_source_info *filter_data =
-				obs_obj_get_data(filter);
-			parent = obs_filter_get_parent(filter);
-			source = obs_sceneitem_get_source(
-				filter_data->scene_item);
-			next_move_name = filter_data->next_move_name;
-			next_move_on = filter_data->next_move_on;
-
-		} else if (filter &&
-			   (strcmp(obs_source_get_unversioned_id(filter),
-				   MOVE_VALUE_FILTER_ID) == 0 ||
-			    strcmp(obs_source_get_unversioned_id(filter),
-				   MOVE_AUDIO_VALUE_FILTER_ID) == 0)) {
-			struct move_value_info *filter_data =
-				obs_obj_get_data(filter);
-			parent = obs_filter_get_parent(filter);
-			source = NULL;
-			next_move_name = filter_data->next_move_name;
-			next_move_on = filter_data->next_move_on;
-
-		} else {
-			obs_source_release(filter);
-			move_source_start(move_source);
-			move_source->filters_done.num = 0;
-			da_push_back(move_source->filters_done,
-				     &move_source->source);
-			return;
-		}
-		obs_source_release(filter);
-		i++;
-	}
-	for (i = 0; i < move_source->filters_done.num; i++) {
-		if (move_source->filters_done.array[i] == filter) {
-			move_source_start(move_source);
-			move_source->filters_done.num = 0;
-			da_push_back(move_source->filters_done,
-				     &move_source->source);
-			return;
-		}
-	}
-	if (strcmp(obs_source_get_unversioned_id(filter),
-		   MOVE_SOURCE_FILTER_ID) == 0) {
-		move_source_start(obs_obj_get_data(filter));
-
-	} else if (strcmp(obs_source_get_unversioned_id(filter),
-			  MOVE_VALUE_FILTER_ID) == 0 ||
-		   strcmp(obs_source_get_unversioned_id(filter),
-			  MOVE_AUDIO_VALUE_FILTER_ID) == 0) {
-		move_value_start(obs_obj_get_data(filter));
-	}
-	da_push_back(move_source->filters_done, &filter);
+	move_chain_hotkey(&move_source->chain, move_source->source, false);
 
 	UNUSED_PARAMETER(id);
 	UNUSED_PARAMETER(hotkey);
@@ -328,9 +402,16 @@ void move_source_source_hide(void *data, calldata_t *call_data)
 	UNUSED_PARAMETER(call_data);
 }
 
+AHEasingFunction get_easing_function(long long easing,
+				     long long easing_function);
+
+void move_source_source_rename(void *data, const char *prev_name,
+			       const char *new_name);
+
 void move_source_update(void *data, obs_data_t *settings)
 {
 	struct move_source_info *move_source = data;
+	move_chains_invalidate();
 	obs_source_t *parent = obs_filter_get_parent(move_source->source);
 	obs_scene_t *scene = obs_scene_from_source(parent);
 	const char *source_name = obs_data_get_string(settings, S_SOURCE);
@@ -390,7 +471,7 @@ void move_source_update(void *data, obs_data_t *settings)
 		obs_sceneitem_release(move_source->scene_item);
 		move_source->scene_item = NULL;
 		if (move_source->source_name)
-			obs_scene_enum_items(scene, find_sceneitem, data);
+			move_source_find_sceneitem(move_source, scene);
 	}
 	const char *filter_name = obs_source_get_name(move_source->source);
 	if (!move_source->filter_name ||
@@ -420,6 +501,8 @@ void move_source_update(void *data, obs_data_t *settings)
 	move_source->easing = obs_data_get_int(settings, S_EASING_MATCH);
 	move_source->easing_function =
 		obs_data_get_int(settings, S_EASING_FUNCTION_MATCH);
+	move_source->ease = get_easing_function(move_source->easing,
+						move_source->easing_function);
 	move_source->relative =
 		obs_data_get_bool(settings, S_TRANSFORM_RELATIVE);
 	if (!move_source->relative) {
@@ -451,6 +534,8 @@ void move_source_update(void *data, obs_data_t *settings)
 	move_source->change_order = obs_data_get_int(settings, S_CHANGE_ORDER);
 	move_source->order_position =
 		obs_data_get_int(settings, S_ORDER_POSITION);
+	move_rename_subscribe(move_source, source_name,
+			      move_source_source_rename);
 }
 
 void update_transform_text(obs_data_t *settings)
@@ -482,22 +567,31 @@ void move_source_load(void *data, obs_data_t *settings)
 	update_transform_text(settings);
 }
 
-void move_source_source_rename(void *data, calldata_t *call_data)
+void move_source_source_rename(void *data, const char *prev_name,
+			       const char *new_name)
 {
 	struct move_source_info *move_source = data;
-	const char *new_name = calldata_string(call_data, "new_name");
-	const char *prev_name = calldata_string(call_data, "prev_name");
 	obs_data_t *settings = obs_source_get_settings(move_source->source);
-	if (!settings || !new_name || !prev_name)
+	if (!settings)
 		return;
 	const char *source_name = obs_data_get_string(settings, S_SOURCE);
 	if (source_name && strlen(source_name) &&
 	    strcmp(source_name, prev_name) == 0) {
 		obs_data_set_string(settings, S_SOURCE, new_name);
+		move_rename_subscribe(move_source, new_name,
+				      move_source_source_rename);
 	}
 	obs_data_release(settings);
 }
 
+void move_source_enable(void *data, calldata_t *call_data)
+{
+	struct move_source_info *move_source = data;
+	move_animation_queue(move_source->source, move_source,
+			     move_source_tick);
+	UNUSED_PARAMETER(call_data);
+}
+
 static void *move_source_create(obs_data_t *settings, obs_source_t *source)
 {
 	struct move_source_info *move_source =
@@ -505,16 +599,21 @@ static void *move_source_create(obs_data_t *settings, obs_source_t *source)
 	move_source->source = source;
 	move_source->move_start_hotkey = OBS_INVALID_HOTKEY_ID;
 	move_source_update(move_source, settings);
-	signal_handler_connect(obs_get_signal_handler(), "source_rename",
-			       move_source_source_rename, move_source);
+	signal_handler_connect(obs_source_get_signal_handler(source), "enable",
+			       move_source_enable, move_source);
+	// first tick picks up the initial enabled state
+	move_animation_queue(source, move_source, move_source_tick);
 	return move_source;
 }
 
 static void move_source_destroy(void *data)
 {
 	struct move_source_info *move_source = data;
-	signal_handler_disconnect(obs_get_signal_handler(), "source_rename",
-				  move_source_source_rename, move_source);
+	move_animation_remove(move_source);
+	move_rename_unsubscribe(move_source);
+	signal_handler_disconnect(obs_source_get_signal_handler(
+					  move_source->source),
+				  "enable", move_source_enable, move_source);
 
 	obs_source_t *source = NULL;
 	if (move_source->scene_item) {
@@ -541,13 +640,14 @@ static void move_source_destroy(void *data)
 		}
 	}
 	obs_sceneitem_release(move_source->scene_item);
+	scene_item_index_release(move_source->item_index);
 	if (move_source->move_start_hotkey != OBS_INVALID_HOTKEY_ID)
 		obs_hotkey_unregister(move_source->move_start_hotkey);
 
 	bfree(move_source->source_name);
 	bfree(move_source->filter_name);
 	bfree(move_source->next_move_name);
-	da_free(move_source->filters_done);
+	move_chain_free(&move_source->chain);
 	bfree(move_source);
 }
 
@@ -565,8 +665,7 @@ bool move_source_get_transform(obs_properties_t *props,
 		if (parent) {
 			obs_scene_t *scene = obs_scene_from_source(parent);
 			if (scene)
-				obs_scene_enum_items(scene, find_sceneitem,
-						     data);
+				move_source_find_sceneitem(move_source, scene);
 		}
 	}
 	if (!move_source->scene_item)
@@ -655,7 +754,7 @@ bool move_source_changed(void *data, obs_properties_t *props,
 	if (parent) {
 		obs_scene_t *scene = obs_scene_from_source(parent);
 		if (scene)
-			obs_scene_enum_items(scene, find_sceneitem, data);
+			move_source_find_sceneitem(move_source, scene);
 	}
 	obs_property_t *p = obs_properties_get(props, S_NEXT_MOVE);
 	if (p) {
@@ -735,8 +834,7 @@ bool move_source_transform_relative_changed(void *data, obs_properties_t *props,
 		if (parent) {
 			obs_scene_t *scene = obs_scene_from_source(parent);
 			if (scene)
-				obs_scene_enum_items(scene, find_sceneitem,
-						     data);
+				move_source_find_sceneitem(move_source, scene);
 		}
 	}
 	struct vec2 pos;
@@ -830,7 +928,7 @@ static obs_properties_t *move_source_properties(void *data)
 	}
 	if (!move_source->scene_item && move_source->source_name &&
 	    strlen(move_source->source_name)) {
-		obs_scene_enum_items(scene, find_sceneitem, move_source);
+		move_source_find_sceneitem(move_source, scene);
 	}
 	obs_property_t *p = obs_properties_add_list(ppts, S_SOURCE,
 						    obs_module_text("Source"),
@@ -991,11 +1089,26 @@ static const char *move_source_get_name(void *type_data)
 	return obs_module_text("MoveSourceFilter");
 }
 
-float get_eased(float f, long long easing, long long easing_function);
 void vec2_bezier(struct vec2 *dst, struct vec2 *begin, struct vec2 *control,
 		 struct vec2 *end, const float t);
 
-void move_source_tick(void *data, float seconds)
+void move_source_filter_add(void *data, obs_source_t *parent)
+{
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(parent);
+	move_chains_invalidate();
+}
+
+void move_source_filter_remove(void *data, obs_source_t *parent)
+{
+	struct move_source_info *move_source = data;
+	move_chains_invalidate();
+	scene_item_index_release(move_source->item_index);
+	move_source->item_index = NULL;
+	UNUSED_PARAMETER(parent);
+}
+
+bool move_source_tick(void *data, float seconds)
 {
 	struct move_source_info *move_source = data;
 	const bool enabled = obs_source_enabled(move_source->source);
@@ -1007,11 +1120,11 @@ void move_source_tick(void *data, float seconds)
 		move_source->enabled = enabled;
 	}
 	if (!move_source->moving || !enabled)
-		return;
+		return false;
 
 	if (!move_source->scene_item || !move_source->duration) {
 		move_source->moving = false;
-		return;
+		return false;
 	}
 	move_source->running_duration += seconds;
 	if (move_source->running_duration * 1000.0f <
@@ -1034,7 +1147,7 @@ void move_source_tick(void *data, float seconds)
 		} else if (move_source->relative) {
 			calc_relative_to(move_source, -1.0f);
 		}
-		return;
+		return true;
 	}
 	if (move_source->running_duration * 1000.0f >=
 	    (float)(move_source->start_delay + move_source->duration +
@@ -1051,7 +1164,8 @@ void move_source_tick(void *data, float seconds)
 	if (move_source->reverse) {
 		t = 1.0f - t;
 	}
-	t = get_eased(t, move_source->easing, move_source->easing_function);
+	if (move_source->ease)
+		t = move_source->ease(t);
 
 	float ot = t;
 	if (t > 1.0f)
@@ -1251,6 +1365,7 @@ void move_source_tick(void *data, float seconds)
 			move_source->reverse = !move_source->reverse;
 		}
 	}
+	return move_source->moving;
 }
 
 void move_source_activate(void *data)
@@ -1291,9 +1406,10 @@ struct obs_source_info move_source_filter = {
 	.get_properties = move_source_properties,
 	.get_defaults = move_source_defaults,
 	.video_render = move_source_video_render,
-	.video_tick = move_source_tick,
 	.update = move_source_update,
 	.load = move_source_load,
+	.filter_add = move_source_filter_add,
+	.filter_remove = move_source_filter_remove,
 	.activate = move_source_activate,
 	.deactivate = move_source_deactivate,
 	.show = move_source_show,
@@ -0,0 +1,148 @@
+#include "move-transition.h"
+#include <util/threading.h>
+
+// bumped on anything that can change where a next move name points to
+static volatile long move_chains_generation = 0;
+
+void move_source_start(struct move_source_info *move_source);
+void move_value_start(struct move_value_info *move_value);
+
+void move_chains_invalidate(void)
+{
+	os_atomic_inc_long(&move_chains_generation);
+}
+
+static void move_chains_rename(void *data, const char *prev_name,
+			       const char *new_name)
+{
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(prev_name);
+	UNUSED_PARAMETER(new_name);
+	move_chains_invalidate();
+}
+
+void move_chains_init(void)
+{
+	move_rename_subscribe((void *)&move_chains_generation, NULL,
+			      move_chains_rename);
+}
+
+void move_chains_free(void)
+{
+	move_rename_unsubscribe((void *)&move_chains_generation);
+}
+
+static void move_chain_clear(struct move_chain *chain)
+{
+	for (size_t i = 0; i < chain->steps.num; i++)
+		obs_weak_source_release(chain->steps.array[i].filter);
+	chain->steps.num = 0;
+}
+
+void move_chain_free(struct move_chain *chain)
+{
+	move_chain_clear(chain);
+	da_free(chain->steps);
+}
+
+static bool move_chain_contains(struct move_chain *chain, obs_source_t *filter)
+{
+	for (size_t i = 0; i < chain->steps.num; i++) {
+		if (chain->steps.array[i].source == filter)
+			return true;
+	}
+	return false;
+}
+
+static void move_chain_build(struct move_chain *chain, obs_source_t *filter,
+			     bool values_only)
+{
+	move_chain_clear(chain);
+	while (filter) {
+		const char *id = obs_source_get_unversioned_id(filter);
+		const bool value = strcmp(id, MOVE_VALUE_FILTER_ID) == 0 ||
+				   strcmp(id, MOVE_AUDIO_VALUE_FILTER_ID) == 0;
+		if ((!value && (values_only ||
+				strcmp(id, MOVE_SOURCE_FILTER_ID) != 0)) ||
+		    move_chain_contains(chain, filter)) {
+			obs_source_release(filter);
+			break;
+		}
+		struct move_chain_step *step = da_push_back_new(chain->steps);
+		step->filter = obs_source_get_weak_source(filter);
+		step->source = filter;
+		step->value = value;
+
+		const char *next_move_name;
+		obs_source_t *source = NULL;
+		if (value) {
+			struct move_value_info *move_value =
+				obs_obj_get_data(filter);
+			next_move_name = move_value->next_move_name;
+			step->next_move_on = move_value->next_move_on;
+		} else {
+			struct move_source_info *move_source =
+				obs_obj_get_data(filter);
+			next_move_name = move_source->next_move_name;
+			step->next_move_on = move_source->next_move_on;
+			source = obs_sceneitem_get_source(
+				move_source->scene_item);
+		}
+		obs_source_t *parent = obs_filter_get_parent(filter);
+		obs_source_t *next = NULL;
+		if (next_move_name && strlen(next_move_name)) {
+			if (parent)
+				next = obs_source_get_filter_by_name(
+					parent, next_move_name);
+			if (!next && source)
+				next = obs_source_get_filter_by_name(
+					source, next_move_name);
+		}
+		obs_source_release(filter);
+		filter = next;
+	}
+}
+
+void move_chain_hotkey(struct move_chain *chain, obs_source_t *filter,
+		       bool values_only)
+{
+	const long generation = os_atomic_load_long(&move_chains_generation);
+	if (!chain->steps.num || chain->generation != generation) {
+		obs_source_addref(filter);
+		move_chain_build(chain, filter, values_only);
+		chain->generation = generation;
+		if (chain->cursor >= chain->steps.num)
+			chain->started = false;
+	}
+	if (!chain->steps.num)
+		return;
+
+	// filters chained on end were already started by the one before them
+	size_t next = 0;
+	if (chain->started) {
+		next = chain->cursor + 1;
+		while (next < chain->steps.num &&
+		       chain->steps.array[next - 1].next_move_on !=
+			       NEXT_MOVE_ON_HOTKEY)
+			next++;
+		if (next >= chain->steps.num)
+			next = 0;
+	}
+
+	struct move_chain_step *step = &chain->steps.array[next];
+	obs_source_t *source = obs_weak_source_get_source(step->filter);
+	if (!source && next) {
+		next = 0;
+		step = &chain->steps.array[0];
+		source = obs_weak_source_get_source(step->filter);
+	}
+	chain->cursor = next;
+	chain->started = true;
+	if (!source)
+		return;
+	if (step->value)
+		move_value_start(obs_obj_get_data(source));
+	else
+		move_source_start(obs_obj_get_data(source));
+	obs_source_release(source);
+}
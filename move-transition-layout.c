@@ -0,0 +1,718 @@
+#include "move-transition.h"
+#include "graphics/math-defs.h"
+#include "graphics/matrix4.h"
+
+void add_alignment(struct vec2 *v, uint32_t align, int cx, int cy)
+{
+	if (align & OBS_ALIGN_RIGHT)
+		v->x += (float)cx;
+	else if ((align & OBS_ALIGN_LEFT) == 0)
+		v->x += (float)(cx >> 1);
+
+	if (align & OBS_ALIGN_BOTTOM)
+		v->y += (float)cy;
+	else if ((align & OBS_ALIGN_TOP) == 0)
+		v->y += (float)(cy >> 1);
+}
+
+void add_move_alignment(struct vec2 *v, uint32_t align_a, uint32_t align_b,
+			float t, int cx, int cy)
+{
+	if (align_a & OBS_ALIGN_RIGHT)
+		v->x += (float)cx * (1.0f - t);
+	else if ((align_a & OBS_ALIGN_LEFT) == 0)
+		v->x += (float)(cx >> 1) * (1.0f - t);
+
+	if (align_a & OBS_ALIGN_BOTTOM)
+		v->y += (float)cy * (1.0f - t);
+	else if ((align_a & OBS_ALIGN_TOP) == 0)
+		v->y += (float)(cy >> 1) * (1.0f - t);
+
+	if (align_b & OBS_ALIGN_RIGHT)
+		v->x += (float)cx * t;
+	else if ((align_b & OBS_ALIGN_LEFT) == 0)
+		v->x += (float)(cx >> 1) * t;
+
+	if (align_b & OBS_ALIGN_BOTTOM)
+		v->y += (float)cy * t;
+	else if ((align_b & OBS_ALIGN_TOP) == 0)
+		v->y += (float)(cy >> 1) * t;
+}
+
+static void calculate_bounds_data(uint32_t item_bounds_type,
+				  uint32_t bounds_alignment,
+				  struct vec2 *origin, struct vec2 *scale,
+				  uint32_t *cx, uint32_t *cy,
+				  struct vec2 *bounds)
+{
+	float width = (float)(*cx) * fabsf(scale->x);
+	float height = (float)(*cy) * fabsf(scale->y);
+	const float item_aspect = width / height;
+	const float bounds_aspect = bounds->x / bounds->y;
+	uint32_t bounds_type = item_bounds_type;
+
+	if (bounds_type == OBS_BOUNDS_MAX_ONLY)
+		if (width > bounds->x || height > bounds->y)
+			bounds_type = OBS_BOUNDS_SCALE_INNER;
+
+	if (bounds_type == OBS_BOUNDS_SCALE_INNER ||
+	    bounds_type == OBS_BOUNDS_SCALE_OUTER) {
+		bool use_width = (bounds_aspect < item_aspect);
+
+		if (item_bounds_type == OBS_BOUNDS_SCALE_OUTER)
+			use_width = !use_width;
+
+		const float mul = use_width ? bounds->x / width
+					    : bounds->y / height;
+
+		vec2_mulf(scale, scale, mul);
+
+	} else if (bounds_type == OBS_BOUNDS_SCALE_TO_WIDTH) {
+		vec2_mulf(scale, scale, bounds->x / width);
+
+	} else if (bounds_type == OBS_BOUNDS_SCALE_TO_HEIGHT) {
+		vec2_mulf(scale, scale, bounds->y / height);
+
+	} else if (bounds_type == OBS_BOUNDS_STRETCH) {
+		scale->x = bounds->x / (float)(*cx);
+		scale->y = bounds->y / (float)(*cy);
+	}
+
+	width = (float)(*cx) * scale->x;
+	height = (float)(*cy) * scale->y;
+	const float width_diff = bounds->x - width;
+	const float height_diff = bounds->y - height;
+	*cx = (uint32_t)bounds->x;
+	*cy = (uint32_t)bounds->y;
+
+	add_alignment(origin, bounds_alignment, (int)-width_diff,
+		      (int)-height_diff);
+}
+
+static void calculate_move_bounds_data(uint32_t bounds_type_a,
+				       uint32_t bounds_alignment_a,
+				       uint32_t bounds_type_b,
+				       uint32_t bounds_alignment_b, float t,
+				       struct vec2 *origin, struct vec2 *scale,
+				       uint32_t *cx, uint32_t *cy,
+				       struct vec2 *bounds)
+{
+	struct vec2 origin_a;
+	vec2_set(&origin_a, origin->x, origin->y);
+	struct vec2 origin_b;
+	vec2_set(&origin_b, origin->x, origin->y);
+
+	struct vec2 scale_a;
+	vec2_set(&scale_a, scale->x, scale->y);
+	struct vec2 scale_b;
+	vec2_set(&scale_b, scale->x, scale->y);
+	uint32_t cxa = *cx;
+	uint32_t cxb = *cx;
+	uint32_t cya = *cy;
+	uint32_t cyb = *cy;
+	calculate_bounds_data(bounds_type_a, bounds_alignment_a, &origin_a,
+			      &scale_a, &cxa, &cya, bounds);
+	calculate_bounds_data(bounds_type_b, bounds_alignment_b, &origin_b,
+			      &scale_b, &cxb, &cyb, bounds);
+	vec2_set(origin, origin_a.x * (1.0f - t) + origin_b.x * t,
+		 origin_a.y * (1.0f - t) + origin_b.y * t);
+	vec2_set(scale, scale_a.x * (1.0f - t) + scale_b.x * t,
+		 scale_a.y * (1.0f - t) + scale_b.y * t);
+	*cx = (uint32_t)((float)cxa * (1.0f - t) + (float)cxb * t);
+	*cy = (uint32_t)((float)cya * (1.0f - t) + (float)cyb * t);
+}
+
+static inline void snapshot_get_pos(const struct move_snapshot_side *side,
+				    size_t i, struct vec2 *pos)
+{
+	vec2_set(pos, side->pos_x[i], side->pos_y[i]);
+}
+
+static inline void snapshot_get_scale(const struct move_snapshot_side *side,
+				      size_t i, struct vec2 *scale)
+{
+	vec2_set(scale, side->scale_x[i], side->scale_y[i]);
+}
+
+static inline void snapshot_get_bounds(const struct move_snapshot_side *side,
+				       size_t i, struct vec2 *bounds)
+{
+	vec2_set(bounds, side->bounds_x[i], side->bounds_y[i]);
+}
+
+static inline void snapshot_get_crop(const struct move_snapshot_side *side,
+				     size_t i, struct obs_sceneitem_crop *crop)
+{
+	crop->left = side->crop_left[i];
+	crop->top = side->crop_top[i];
+	crop->right = side->crop_right[i];
+	crop->bottom = side->crop_bottom[i];
+}
+
+void pos_add_center(struct vec2 *pos, uint32_t alignment, uint32_t cx,
+		    uint32_t cy)
+{
+	if (alignment & OBS_ALIGN_LEFT) {
+		pos->x -= cx >> 1;
+	} else if (alignment & OBS_ALIGN_RIGHT) {
+		pos->x += cx >> 1;
+	}
+	if (alignment & OBS_ALIGN_TOP) {
+		pos->y -= cy >> 1;
+	} else if (alignment & OBS_ALIGN_BOTTOM) {
+		pos->y += cy >> 1;
+	}
+}
+
+void pos_subtract_center(struct vec2 *pos, uint32_t alignment, uint32_t cx,
+			 uint32_t cy)
+{
+	if (alignment & OBS_ALIGN_LEFT) {
+		pos->x += cx >> 1;
+	} else if (alignment & OBS_ALIGN_RIGHT) {
+		pos->x -= cx >> 1;
+	}
+	if (alignment & OBS_ALIGN_TOP) {
+		pos->y += cy >> 1;
+	} else if (alignment & OBS_ALIGN_BOTTOM) {
+		pos->y -= cy >> 1;
+	}
+}
+
+void calc_edge_position(struct vec2 *pos, long long position,
+			uint32_t canvas_width, uint32_t canvas_height,
+			uint32_t alignment, uint32_t cx, uint32_t cy, bool zoom)
+{
+	uint32_t cx2 = cx >> 1;
+	uint32_t cy2 = cy >> 1;
+	if (zoom) {
+		cx2 = 0;
+		cy2 = 0;
+	}
+
+	if (position - POS_EDGE == 0) {
+		if (alignment & OBS_ALIGN_LEFT) {
+			pos->x += cx >> 1;
+		} else if (alignment & OBS_ALIGN_RIGHT) {
+			pos->x -= cx >> 1;
+		}
+		if (alignment & OBS_ALIGN_TOP) {
+			pos->y += cy >> 1;
+		} else if (alignment & OBS_ALIGN_BOTTOM) {
+			pos->y -= cy >> 1;
+		}
+		// pos is center of object
+		float diff_x = pos->x - (canvas_width >> 1);
+		float diff_y = pos->y - (canvas_height >> 1);
+		float factor_x = fabsf(diff_x) / (canvas_width >> 1);
+		float factor_y = fabsf(diff_y) / (canvas_height >> 1);
+
+		if (diff_x == 0.0f && diff_y == 0.0f) {
+			diff_y = 1.0f;
+		}
+		if (factor_x > factor_y) {
+			if (diff_x < 0.0f) {
+				//left edge
+				const float move_x = -(pos->x + cx2);
+				const float move_y =
+					diff_y * (diff_x + move_x) / diff_x;
+				vec2_set(pos, -(float)cx2,
+					 (float)(canvas_height >> 1) + move_y);
+			} else {
+				//right edge
+				const float move_x =
+					(canvas_width - pos->x) + cx2;
+				const float move_y =
+					diff_y * (diff_x + move_x) / diff_x;
+				vec2_set(pos, (float)canvas_width + cx2,
+					 (float)(canvas_height >> 1) + move_y);
+			}
+		} else {
+			if (diff_y < 0.0f) {
+				//top edge
+				const float move_y = -(pos->y + cy2);
+				const float move_x =
+					diff_x * (diff_y + move_y) / diff_y;
+				vec2_set(pos,
+					 (float)(canvas_width >> 1) + move_x,
+					 -(float)cy2);
+			} else {
+				//bottom edge
+				const float move_y =
+					(canvas_height - pos->y) + cy2;
+				const float move_x =
+					diff_x * (diff_y + move_y) / diff_y;
+				vec2_set(pos,
+					 (float)(canvas_width >> 1) + move_x,
+					 (float)canvas_height + cy2);
+			}
+		}
+
+		if (alignment & OBS_ALIGN_LEFT) {
+			pos->x -= cx2;
+		} else if (alignment & OBS_ALIGN_RIGHT) {
+			pos->x += cx2;
+		}
+		if (alignment & OBS_ALIGN_TOP) {
+			pos->y -= cy2;
+		} else if (alignment & OBS_ALIGN_BOTTOM) {
+			pos->y += cy2;
+		}
+
+		return;
+	}
+	if (zoom) {
+		cx = 0;
+		cy = 0;
+	}
+	if (position & POS_EDGE)
+		vec2_set(pos, 0, 0);
+	if (position & POS_RIGHT) {
+		pos->x = (float)canvas_width;
+		if (alignment & OBS_ALIGN_RIGHT) {
+			pos->x += cx;
+		} else if (alignment & OBS_ALIGN_LEFT) {
+
+		} else {
+			pos->x += cx2;
+		}
+	} else if (position & POS_LEFT) {
+		pos->x = 0;
+		if (alignment & OBS_ALIGN_RIGHT) {
+
+		} else if (alignment & OBS_ALIGN_LEFT) {
+			pos->x -= cx;
+		} else {
+			pos->x -= cx2;
+		}
+	} else if (position & POS_EDGE) {
+		pos->x = (float)(canvas_width >> 1);
+		if (alignment & OBS_ALIGN_RIGHT) {
+			pos->x += cx2;
+		} else if (alignment & OBS_ALIGN_LEFT) {
+			pos->x -= cx2;
+		}
+	}
+
+	if (position & POS_BOTTOM) {
+		pos->y = (float)canvas_height;
+		if (alignment & OBS_ALIGN_TOP) {
+		} else if (alignment & OBS_ALIGN_BOTTOM) {
+			pos->y += cy;
+		} else {
+			pos->y += cy2;
+		}
+	} else if (position & POS_TOP) {
+		pos->y = 0;
+		if (alignment & OBS_ALIGN_BOTTOM) {
+		} else if (alignment & OBS_ALIGN_TOP) {
+			pos->y -= cy;
+		} else {
+			pos->y -= cy2;
+		}
+	} else if (position & POS_EDGE) {
+		pos->y = (float)(canvas_height >> 1);
+		if (alignment & OBS_ALIGN_TOP) {
+			pos->y -= cy2;
+		} else if (alignment & OBS_ALIGN_BOTTOM) {
+			pos->y += cy2;
+		}
+	}
+}
+
+// closed form quadratic bezier, the weights are shared by x and y
+void vec2_bezier(struct vec2 *dst, struct vec2 *begin, struct vec2 *control,
+		 struct vec2 *end, const float t)
+{
+	const float p = 1.0f - t;
+	const float w0 = p * p;
+	const float w1 = 2.0f * p * t;
+	const float w2 = t * t;
+	dst->x = w0 * begin->x + w1 * control->x + w2 * end->x;
+	dst->y = w0 * begin->y + w1 * control->y + w2 * end->y;
+}
+
+obs_sceneitem_t *move_item_scene_item(float t, struct move_item *item)
+{
+	if (item->item_a && item->item_b)
+		return t <= 0.5 ? item->item_a : item->item_b;
+	return item->item_a ? item->item_a : item->item_b;
+}
+
+// items next to each other mostly share a curve, so ease them in runs
+static void move_frame_ease(struct move_frame *frame, size_t num)
+{
+	size_t start = 0;
+	while (start < num) {
+		AHEasingFunction ease = frame->ease.array[start];
+		size_t end = start + 1;
+		while (end < num && frame->ease.array[end] == ease)
+			end++;
+		if (ease)
+			EaseBatch(ease, frame->t + start, frame->t + start,
+				  end - start);
+		start = end;
+	}
+	for (size_t i = 0; i < num; i++) {
+		const float t = frame->t[i];
+		frame->ot[i] = t > 1.0f ? 1.0f : (t < 0.0f ? 0.0f : t);
+	}
+}
+
+// one branch free pass over every item so the compiler can vectorize it,
+// the result is only used for items that have both sides
+static void move_frame_lerp(struct move_frame *frame,
+			    const struct move_snapshot *snapshot)
+{
+	const struct move_snapshot_side *a = &snapshot->side[SNAPSHOT_A];
+	const struct move_snapshot_side *b = &snapshot->side[SNAPSHOT_B];
+	const size_t num = snapshot->num;
+	for (size_t i = 0; i < num; i++) {
+		const float t = frame->t[i];
+		frame->pos_x[i] = (1.0f - t) * a->pos_x[i] + t * b->pos_x[i];
+		frame->pos_y[i] = (1.0f - t) * a->pos_y[i] + t * b->pos_y[i];
+		frame->scale_x[i] =
+			(1.0f - t) * a->scale_x[i] + t * b->scale_x[i];
+		frame->scale_y[i] =
+			(1.0f - t) * a->scale_y[i] + t * b->scale_y[i];
+		frame->bounds_x[i] =
+			(1.0f - t) * a->bounds_x[i] + t * b->bounds_x[i];
+		frame->bounds_y[i] =
+			(1.0f - t) * a->bounds_y[i] + t * b->bounds_y[i];
+		frame->rot[i] = (1.0f - t) * a->rot[i] + t * b->rot[i];
+	}
+	for (size_t i = 0; i < num; i++) {
+		const float ot = frame->ot[i];
+		frame->crop_left[i] = (1.0f - ot) * (float)a->crop_left[i] +
+				      ot * (float)b->crop_left[i];
+		frame->crop_top[i] = (1.0f - ot) * (float)a->crop_top[i] +
+				     ot * (float)b->crop_top[i];
+		frame->crop_right[i] = (1.0f - ot) * (float)a->crop_right[i] +
+				       ot * (float)b->crop_right[i];
+		frame->crop_bottom[i] =
+			(1.0f - ot) * (float)a->crop_bottom[i] +
+			ot * (float)b->crop_bottom[i];
+	}
+}
+
+static void move_item_layout(struct move_snapshot *snapshot,
+			     struct move_frame *frame, struct move_item *item)
+{
+	obs_sceneitem_t *scene_item = move_item_scene_item(frame->move_t, item);
+	const size_t i = item->snapshot_index;
+	struct move_snapshot_side *side_a = &snapshot->side[SNAPSHOT_A];
+	struct move_snapshot_side *side_b = &snapshot->side[SNAPSHOT_B];
+	struct move_snapshot_side *side =
+		scene_item == item->item_a ? side_a : side_b;
+	const size_t s = scene_item == item->item_a ? SNAPSHOT_A : SNAPSHOT_B;
+	uint32_t width = frame->source_cx[s][i];
+	uint32_t height = frame->source_cy[s][i];
+	bool move_out = item->item_a == scene_item;
+	const float t = frame->t[i];
+	const float ot = frame->ot[i];
+
+	if (item->item_a && item->item_b && item->transition &&
+	    !frame->start_init) {
+		uint32_t width_a = frame->source_cx[SNAPSHOT_A][i];
+		uint32_t width_b = frame->source_cx[SNAPSHOT_B][i];
+		uint32_t height_a = frame->source_cy[SNAPSHOT_A][i];
+		uint32_t height_b = frame->source_cy[SNAPSHOT_B][i];
+		width = (uint32_t)((1.0f - t) * width_a + t * width_b);
+		height = (uint32_t)((1.0f - t) * height_a + t * height_b);
+		obs_transition_set_size(item->transition, width, height);
+	}
+
+	uint32_t original_width = width;
+	uint32_t original_height = height;
+	struct obs_sceneitem_crop crop;
+	if (item->move_scene) {
+		snapshot_get_crop(side, i, &crop);
+		if (item->item_a) {
+			crop.left =
+				(int)((float)(1.0f - ot) * (float)crop.left);
+			crop.top = (int)((float)(1.0f - ot) * (float)crop.top);
+			crop.right =
+				(int)((float)(1.0f - ot) * (float)crop.right);
+			crop.bottom =
+				(int)((float)(1.0f - ot) * (float)crop.bottom);
+		} else if (item->item_b) {
+			crop.left = (int)((float)ot * (float)crop.left);
+			crop.top = (int)((float)ot * (float)crop.top);
+			crop.right = (int)((float)ot * (float)crop.right);
+			crop.bottom = (int)((float)ot * (float)crop.bottom);
+		}
+	} else if (item->item_a && item->item_b) {
+		crop.left = (int)frame->crop_left[i];
+		crop.top = (int)frame->crop_top[i];
+		crop.right = (int)frame->crop_right[i];
+		crop.bottom = (int)frame->crop_bottom[i];
+	} else {
+		snapshot_get_crop(side, i, &crop);
+	}
+	uint32_t crop_cx = crop.left + crop.right;
+	uint32_t cx = (crop_cx > width) ? 2 : (width - crop_cx);
+	uint32_t crop_cy = crop.top + crop.bottom;
+	uint32_t cy = (crop_cy > height) ? 2 : (height - crop_cy);
+	struct vec2 scale;
+	struct vec2 original_scale;
+	snapshot_get_scale(side, i, &original_scale);
+	if (item->item_a && item->item_b) {
+		vec2_set(&scale, frame->scale_x[i], frame->scale_y[i]);
+	} else {
+		if (side->bounds_type[i] != OBS_BOUNDS_NONE) {
+			snapshot_get_scale(side, i, &scale);
+		} else {
+			snapshot_get_scale(side, i, &scale);
+			if (item->move_scene) {
+				if (item->item_a) {
+					vec2_set(&scale,
+						 (1.0f - t) * scale.x + t,
+						 (1.0f - t) * scale.y + t);
+				} else if (item->item_b) {
+					vec2_set(&scale,
+						 (1.0f - t) + t * scale.x,
+						 (1.0f - t) + t * scale.y);
+				}
+			} else if (!move_out && item->zoom) {
+				vec2_set(&scale, t * scale.x, t * scale.y);
+			} else if (move_out && item->zoom) {
+				vec2_set(&scale, (1.0f - t) * scale.x,
+					 (1.0f - t) * scale.y);
+			}
+		}
+	}
+	width = cx;
+	height = cy;
+	uint32_t original_cx = cx;
+	uint32_t original_cy = cy;
+
+	struct vec2 base_origin;
+	struct vec2 origin;
+	struct vec2 origin2;
+	vec2_zero(&base_origin);
+	vec2_zero(&origin);
+	vec2_zero(&origin2);
+
+	uint32_t canvas_width = frame->canvas_width;
+	uint32_t canvas_height = frame->canvas_height;
+
+	if (side->bounds_type[i] != OBS_BOUNDS_NONE) {
+		struct vec2 bounds;
+		if (item->move_scene) {
+			snapshot_get_bounds(side, i, &bounds);
+			if (item->item_a) {
+				vec2_set(&bounds,
+					 (1.0f - t) * bounds.x +
+						 t * canvas_width,
+					 (1.0f - t) * bounds.y +
+						 t * canvas_height);
+			} else if (item->item_b) {
+				vec2_set(&bounds,
+					 (1.0f - t) * canvas_width +
+						 t * bounds.x,
+					 (1.0f - t) * canvas_height +
+						 t * bounds.y);
+			}
+		} else if (item->item_a && item->item_b) {
+			vec2_set(&bounds, frame->bounds_x[i],
+				 frame->bounds_y[i]);
+		} else {
+			snapshot_get_bounds(side, i, &bounds);
+			if (!move_out && item->zoom) {
+				vec2_set(&bounds, t * bounds.x, t * bounds.y);
+			} else if (move_out && item->zoom) {
+				vec2_set(&bounds, (1.0f - t) * bounds.x,
+					 (1.0f - t) * bounds.y);
+			}
+		}
+		if (item->item_a && item->item_b &&
+		    (side_a->bounds_alignment[i] !=
+			     side_b->bounds_alignment[i] ||
+		     side_a->bounds_type[i] != side_b->bounds_type[i])) {
+			calculate_move_bounds_data(side_a->bounds_type[i],
+						   side_a->bounds_alignment[i],
+						   side_b->bounds_type[i],
+						   side_b->bounds_alignment[i],
+						   t, &origin, &scale, &cx, &cy,
+						   &bounds);
+
+		} else {
+			calculate_bounds_data(side->bounds_type[i],
+					      side->bounds_alignment[i],
+					      &origin, &scale, &cx, &cy,
+					      &bounds);
+		}
+		struct vec2 original_bounds;
+		snapshot_get_bounds(side, i, &original_bounds);
+		calculate_bounds_data(side->bounds_type[i],
+				      side->bounds_alignment[i], &origin2,
+				      &original_scale, &original_cx,
+				      &original_cy, &original_bounds);
+	} else {
+		original_cx = (uint32_t)((float)cx * original_scale.x);
+		original_cy = (uint32_t)((float)cy * original_scale.y);
+		cx = (uint32_t)((float)cx * scale.x);
+		cy = (uint32_t)((float)cy * scale.y);
+	}
+	if (item->item_a && item->item_b &&
+	    side_a->alignment[i] != side_b->alignment[i]) {
+		add_move_alignment(&origin, side_a->alignment[i],
+				   side_b->alignment[i], t, (int)cx, (int)cy);
+	} else {
+		add_alignment(&origin, side->alignment[i], (int)cx, (int)cy);
+	}
+
+	struct matrix4 draw_transform;
+	matrix4_identity(&draw_transform);
+	matrix4_scale3f(&draw_transform, &draw_transform, scale.x, scale.y,
+			1.0f);
+	matrix4_translate3f(&draw_transform, &draw_transform, -origin.x,
+			    -origin.y, 0.0f);
+	float rot;
+	if (item->move_scene) {
+		rot = side->rot[i];
+		if (item->item_a) {
+			rot *= (1.0f - t);
+		} else if (item->item_b) {
+			rot *= t;
+		}
+	} else if (item->item_a && item->item_b) {
+		rot = frame->rot[i];
+	} else {
+		rot = side->rot[i];
+	}
+	matrix4_rotate_aa4f(&draw_transform, &draw_transform, 0.0f, 0.0f, 1.0f,
+			    RAD(rot));
+
+	struct vec2 pos_a;
+	if (item->item_a) {
+		snapshot_get_pos(side_a, i, &pos_a);
+	} else if (item->move_scene) {
+		uint32_t alignment = side->alignment[i];
+		vec2_set(&pos_a, 0, 0);
+		if (alignment & OBS_ALIGN_RIGHT) {
+			pos_a.x += canvas_width;
+		} else if (alignment & OBS_ALIGN_LEFT) {
+
+		} else {
+			pos_a.x += canvas_width >> 1;
+		}
+		if (alignment & OBS_ALIGN_BOTTOM) {
+			pos_a.y += canvas_height;
+		} else if (alignment & OBS_ALIGN_TOP) {
+
+		} else {
+			pos_a.x += canvas_height >> 1;
+		}
+	} else {
+		uint32_t alignment = side->alignment[i];
+		if (item->position & POS_CENTER) {
+			vec2_set(&pos_a, (float)(canvas_width >> 1),
+				 (float)(canvas_height >> 1));
+			if (!item->zoom)
+				pos_add_center(&pos_a, alignment, cx, cy);
+		} else if (item->position & POS_EDGE ||
+			   item->position & POS_SWIPE) {
+			snapshot_get_pos(side_b, i, &pos_a);
+			calc_edge_position(&pos_a, item->position, canvas_width,
+					   canvas_height, alignment,
+					   original_cx, original_cy,
+					   item->zoom);
+
+		} else {
+			snapshot_get_pos(side_b, i, &pos_a);
+			if (item->zoom)
+				pos_subtract_center(&pos_a, alignment,
+						    original_cx, original_cy);
+		}
+	}
+	struct vec2 pos_b;
+	if (item->item_b) {
+		snapshot_get_pos(side_b, i, &pos_b);
+	} else if (item->move_scene) {
+		uint32_t alignment = side->alignment[i];
+		vec2_set(&pos_b, 0, 0);
+		if (alignment & OBS_ALIGN_RIGHT) {
+			pos_b.x += canvas_width;
+		} else if (alignment & OBS_ALIGN_LEFT) {
+
+		} else {
+			pos_b.x += canvas_width >> 1;
+		}
+		if (alignment & OBS_ALIGN_BOTTOM) {
+			pos_b.y += canvas_height;
+		} else if (alignment & OBS_ALIGN_TOP) {
+
+		} else {
+			pos_b.x += canvas_height >> 1;
+		}
+	} else {
+		uint32_t alignment = side->alignment[i];
+		if (item->position & POS_CENTER) {
+			vec2_set(&pos_b, (float)(canvas_width >> 1),
+				 (float)(canvas_height >> 1));
+			if (!item->zoom)
+				pos_add_center(&pos_b, alignment, cx, cy);
+		} else if (item->position & POS_EDGE ||
+			   item->position & POS_SWIPE) {
+			snapshot_get_pos(side_a, i, &pos_b);
+			calc_edge_position(&pos_b, item->position, canvas_width,
+					   canvas_height, alignment,
+					   original_cx, original_cy,
+					   item->zoom);
+
+		} else {
+			snapshot_get_pos(side_a, i, &pos_b);
+			if (item->zoom)
+				pos_subtract_center(&pos_b, alignment,
+						    original_cx, original_cy);
+		}
+	}
+	struct vec2 pos;
+	if (item->curve != 0.0f) {
+		float diff_x = fabsf(pos_a.x - pos_b.x);
+		float diff_y = fabsf(pos_a.y - pos_b.y);
+		struct vec2 control_pos;
+		vec2_set(&control_pos, 0.5f * pos_a.x + 0.5f * pos_b.x,
+			 0.5f * pos_a.y + 0.5f * pos_b.y);
+		if (control_pos.x >= (canvas_width >> 1)) {
+			control_pos.x += diff_y * item->curve;
+		} else {
+			control_pos.x -= diff_y * item->curve;
+		}
+		if (control_pos.y >= (canvas_height >> 1)) {
+			control_pos.y += diff_x * item->curve;
+		} else {
+			control_pos.y -= diff_x * item->curve;
+		}
+		vec2_bezier(&pos, &pos_a, &control_pos, &pos_b, t);
+	} else if (item->item_a && item->item_b) {
+		vec2_set(&pos, frame->pos_x[i], frame->pos_y[i]);
+	} else {
+		vec2_set(&pos, (1.0f - t) * pos_a.x + t * pos_b.x,
+			 (1.0f - t) * pos_a.y + t * pos_b.y);
+	}
+
+	matrix4_translate3f(&draw_transform, &draw_transform, pos.x, pos.y,
+			    0.0f);
+
+	struct vec2 output_scale = scale;
+
+	struct move_item_layout *layout = &frame->layouts.array[i];
+	layout->draw_transform = draw_transform;
+	layout->crop = crop;
+	layout->output_scale = output_scale;
+	layout->width = width;
+	layout->height = height;
+	layout->original_width = original_width;
+	layout->original_height = original_height;
+}
+
+void move_frame_layout(struct move_frame *frame, struct move_snapshot *snapshot,
+		       struct move_item **items, size_t num)
+{
+	move_frame_ease(frame, num);
+	move_frame_lerp(frame, snapshot);
+	for (size_t i = 0; i < num; i++)
+		move_item_layout(snapshot, frame, items[i]);
+}
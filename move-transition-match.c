@@ -0,0 +1,287 @@
+#include "move-transition.h"
+#include <stdlib.h>
+
+#define MATCH_NONE ((size_t)-1)
+#define MATCH_HASH_INIT 0xcbf29ce484222325ULL
+#define MATCH_HASH_PRIME 0x100000001b3ULL
+
+bool is_number_match(const char c)
+{
+	if (c >= '0' && c <= '9')
+		return true;
+	if (c == '(' || c == ')' || c == ' ' || c == '.' || c == ',')
+		return true;
+	return false;
+}
+
+static inline uint64_t match_hash_step(uint64_t hash, const char c)
+{
+	return (hash ^ (uint8_t)c) * MATCH_HASH_PRIME;
+}
+
+static uint64_t match_hash(const char *str, size_t len)
+{
+	uint64_t hash = MATCH_HASH_INIT;
+	for (size_t i = 0; i < len; i++)
+		hash = match_hash_step(hash, str[i]);
+	return hash;
+}
+
+// same trimming the part matcher applies to the shorter of two names
+static size_t match_key_len(const char *name, size_t len, bool number_match,
+			    bool last_word_match)
+{
+	if (last_word_match) {
+		const char *last_space = strrchr(name, ' ');
+		if (last_space && last_space > name)
+			len = last_space - name;
+	}
+	while (len > 0 && number_match && is_number_match(name[len - 1]))
+		len--;
+	return len;
+}
+
+static void match_map_build(struct match_map *map)
+{
+	size_t size = 16;
+	while (size < map->entries.num * 2)
+		size <<= 1;
+	da_resize(map->heads, size);
+	for (size_t i = 0; i < size; i++)
+		map->heads.array[i] = MATCH_NONE;
+	map->mask = size - 1;
+	// link in reverse so every chain is in item order
+	for (size_t i = map->entries.num; i > 0; i--) {
+		struct match_map_entry *entry = &map->entries.array[i - 1];
+		size_t *head = &map->heads.array[entry->hash & map->mask];
+		entry->next = *head;
+		*head = i - 1;
+	}
+}
+
+static void match_map_add(struct match_map *map, uint64_t hash, size_t index)
+{
+	struct match_map_entry *entry = da_push_back_new(map->entries);
+	entry->hash = hash;
+	entry->index = index;
+	entry->next = MATCH_NONE;
+}
+
+static void match_map_enum(struct match_index *index, struct match_map *map,
+			   uint64_t hash, match_index_enum_cb cb, void *param)
+{
+	if (!map->heads.num)
+		return;
+	size_t i = map->heads.array[hash & map->mask];
+	while (i != MATCH_NONE) {
+		struct match_map_entry *entry = &map->entries.array[i];
+		if (entry->hash == hash)
+			cb(param, entry->index,
+			   index->entries.array[entry->index].data);
+		i = entry->next;
+	}
+}
+
+static int match_suffix_compare(const void *a, const void *b)
+{
+	const struct match_suffix *sa = a;
+	const struct match_suffix *sb = b;
+	const size_t len = sa->len < sb->len ? sa->len : sb->len;
+	const int r = memcmp(sa->str, sb->str, len);
+	if (r)
+		return r;
+	if (sa->len != sb->len)
+		return sa->len < sb->len ? -1 : 1;
+	return sa->index < sb->index ? -1 : sa->index > sb->index;
+}
+
+void match_index_init(struct match_index *index)
+{
+	memset(index, 0, sizeof(struct match_index));
+}
+
+void match_index_clear(struct match_index *index)
+{
+	index->entries.num = 0;
+	index->unnamed.num = 0;
+	index->exact.entries.num = 0;
+	index->exact.heads.num = 0;
+	index->keys.entries.num = 0;
+	index->keys.heads.num = 0;
+	index->suffixes.num = 0;
+	index->exact_built = false;
+	index->parts_built = false;
+}
+
+void match_index_free(struct match_index *index)
+{
+	da_free(index->entries);
+	da_free(index->unnamed);
+	da_free(index->exact.entries);
+	da_free(index->exact.heads);
+	da_free(index->keys.entries);
+	da_free(index->keys.heads);
+	da_free(index->suffixes);
+}
+
+void match_index_add(struct match_index *index, const char *name, void *data)
+{
+	const size_t i = index->entries.num;
+	struct match_entry *entry = da_push_back_new(index->entries);
+	entry->name = name;
+	entry->len = name ? strlen(name) : 0;
+	entry->data = data;
+	entry->settings_hashed = false;
+	if (!name)
+		da_push_back(index->unnamed, &i);
+	index->exact_built = false;
+	index->parts_built = false;
+}
+
+bool match_settings_hash(obs_source_t *source, uint64_t *hash)
+{
+	obs_data_t *settings = obs_source_get_settings(source);
+	if (!settings)
+		return false;
+	const char *json = obs_data_get_json(settings);
+	*hash = match_hash(json, json ? strlen(json) : 0);
+	obs_data_release(settings);
+	return true;
+}
+
+bool match_index_settings_hash(struct match_index *index, size_t i,
+			       obs_source_t *source, uint64_t *hash)
+{
+	struct match_entry *entry = &index->entries.array[i];
+	if (!entry->settings_hashed) {
+		entry->has_settings =
+			match_settings_hash(source, &entry->settings_hash);
+		entry->settings_hashed = true;
+	}
+	*hash = entry->settings_hash;
+	return entry->has_settings;
+}
+
+static void match_index_build_exact(struct match_index *index)
+{
+	index->exact.entries.num = 0;
+	for (size_t i = 0; i < index->entries.num; i++) {
+		struct match_entry *entry = &index->entries.array[i];
+		if (entry->name)
+			match_map_add(&index->exact,
+				      match_hash(entry->name, entry->len), i);
+	}
+	match_map_build(&index->exact);
+	index->exact_built = true;
+}
+
+static void match_index_build_parts(struct match_index *index,
+				    bool part_match, bool number_match,
+				    bool last_word_match)
+{
+	index->keys.entries.num = 0;
+	index->suffixes.num = 0;
+	for (size_t i = 0; i < index->entries.num; i++) {
+		struct match_entry *entry = &index->entries.array[i];
+		if (!entry->name || !entry->len)
+			continue;
+		entry->key_len = match_key_len(entry->name, entry->len,
+					       number_match, last_word_match);
+		if (entry->key_len)
+			match_map_add(&index->keys,
+				      match_hash(entry->name, entry->key_len),
+				      i);
+		const size_t starts = part_match ? entry->len : 1;
+		for (size_t s = 0; s < starts; s++) {
+			struct match_suffix *suffix =
+				da_push_back_new(index->suffixes);
+			suffix->str = entry->name + s;
+			suffix->len = entry->len - s;
+			suffix->index = i;
+		}
+	}
+	match_map_build(&index->keys);
+	if (index->suffixes.num)
+		qsort(index->suffixes.array, index->suffixes.num,
+		      sizeof(struct match_suffix), match_suffix_compare);
+	index->part_match = part_match;
+	index->number_match = number_match;
+	index->last_word_match = last_word_match;
+	index->parts_built = true;
+}
+
+void match_index_enum_exact(struct match_index *index, const char *name,
+			    match_index_enum_cb cb, void *param)
+{
+	if (!name) {
+		for (size_t i = 0; i < index->entries.num; i++)
+			cb(param, i, index->entries.array[i].data);
+		return;
+	}
+	if (!index->exact_built)
+		match_index_build_exact(index);
+	match_map_enum(index, &index->exact, match_hash(name, strlen(name)),
+		       cb, param);
+	for (size_t i = 0; i < index->unnamed.num; i++) {
+		const size_t u = index->unnamed.array[i];
+		cb(param, u, index->entries.array[u].data);
+	}
+}
+
+void match_index_enum_parts(struct match_index *index, const char *name,
+			    bool part_match, bool number_match,
+			    bool last_word_match, match_index_enum_cb cb,
+			    void *param)
+{
+	if (!name)
+		return;
+	const size_t len = strlen(name);
+	if (!len)
+		return;
+	if (!index->parts_built || index->part_match != part_match ||
+	    index->number_match != number_match ||
+	    index->last_word_match != last_word_match)
+		match_index_build_parts(index, part_match, number_match,
+					last_word_match);
+
+	// longer names that contain (or start with) this trimmed name
+	const size_t key_len =
+		match_key_len(name, len, number_match, last_word_match);
+	if (key_len) {
+		size_t lo = 0;
+		size_t hi = index->suffixes.num;
+		while (lo < hi) {
+			const size_t mid = lo + ((hi - lo) >> 1);
+			const struct match_suffix *suffix =
+				&index->suffixes.array[mid];
+			const size_t l = suffix->len < key_len ? suffix->len
+							       : key_len;
+			int r = memcmp(suffix->str, name, l);
+			if (!r && suffix->len < key_len)
+				r = -1;
+			if (r < 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		for (size_t i = lo; i < index->suffixes.num; i++) {
+			const struct match_suffix *suffix =
+				&index->suffixes.array[i];
+			if (suffix->len < key_len ||
+			    memcmp(suffix->str, name, key_len) != 0)
+				break;
+			cb(param, suffix->index,
+			   index->entries.array[suffix->index].data);
+		}
+	}
+
+	// shorter names whose trimmed name is contained in (or starts) this one
+	const size_t starts = part_match ? len : 1;
+	for (size_t s = 0; s < starts; s++) {
+		uint64_t hash = MATCH_HASH_INIT;
+		for (size_t e = s; e < len; e++) {
+			hash = match_hash_step(hash, name[e]);
+			match_map_enum(index, &index->keys, hash, cb, param);
+		}
+	}
+}
@@ -1,22 +1,125 @@
 #include "move-transition.h"
 #include <obs-module.h>
+#include <util/threading.h>
 
 struct move_filter_info {
 	obs_source_t *source;
+	pthread_mutex_t override_mutex;
+	struct move_override *override;
 };
 
-void move_filter_source_rename(void *data, calldata_t *call_data)
+static char *move_override_string(obs_data_t *settings, const char *name)
+{
+	const char *str = obs_data_get_string(settings, name);
+	return str && strlen(str) ? bstrdup(str) : NULL;
+}
+
+static struct move_override *move_override_create(obs_data_t *settings)
+{
+	struct move_override *o = bzalloc(sizeof(struct move_override));
+	o->refs = 1;
+	o->source_name = move_override_string(settings, S_SOURCE);
+	o->easing_match = obs_data_get_int(settings, S_EASING_MATCH);
+	o->easing_in = obs_data_get_int(settings, S_EASING_IN);
+	o->easing_out = obs_data_get_int(settings, S_EASING_OUT);
+	o->easing_function_match =
+		obs_data_get_int(settings, S_EASING_FUNCTION_MATCH);
+	o->easing_function_in = obs_data_get_int(settings, S_EASING_FUNCTION_IN);
+	o->easing_function_out =
+		obs_data_get_int(settings, S_EASING_FUNCTION_OUT);
+	o->position_in = obs_data_get_int(settings, S_POSITION_IN);
+	o->position_out = obs_data_get_int(settings, S_POSITION_OUT);
+	o->zoom_in = obs_data_get_int(settings, S_ZOOM_IN);
+	o->zoom_out = obs_data_get_int(settings, S_ZOOM_OUT);
+	o->transition_scale = obs_data_get_int(settings, S_TRANSITION_SCALE);
+	o->transition_match = move_override_string(settings, S_TRANSITION_MATCH);
+	o->transition_in = move_override_string(settings, S_TRANSITION_IN);
+	o->transition_out = move_override_string(settings, S_TRANSITION_OUT);
+	o->curve_override_match =
+		obs_data_get_bool(settings, S_CURVE_OVERRIDE_MATCH);
+	o->curve_override_in = obs_data_get_bool(settings, S_CURVE_OVERRIDE_IN);
+	o->curve_override_out = obs_data_get_bool(settings, S_CURVE_OVERRIDE_OUT);
+	o->curve_match = (float)obs_data_get_double(settings, S_CURVE_MATCH);
+	o->curve_in = (float)obs_data_get_double(settings, S_CURVE_IN);
+	o->curve_out = (float)obs_data_get_double(settings, S_CURVE_OUT);
+	o->start_delay_match_from =
+		obs_data_get_int(settings, S_START_DELAY_MATCH_FROM);
+	o->start_delay_match_to =
+		obs_data_get_int(settings, S_START_DELAY_MATCH_TO);
+	o->start_delay_in = obs_data_get_int(settings, S_START_DELAY_IN);
+	o->start_delay_out = obs_data_get_int(settings, S_START_DELAY_OUT);
+	o->end_delay_match_from =
+		obs_data_get_int(settings, S_END_DELAY_MATCH_FROM);
+	o->end_delay_match_to = obs_data_get_int(settings, S_END_DELAY_MATCH_TO);
+	o->end_delay_in = obs_data_get_int(settings, S_END_DELAY_IN);
+	o->end_delay_out = obs_data_get_int(settings, S_END_DELAY_OUT);
+	return o;
+}
+
+void move_override_release(struct move_override *override)
+{
+	if (!override || os_atomic_dec_long(&override->refs) > 0)
+		return;
+	bfree(override->source_name);
+	bfree(override->transition_match);
+	bfree(override->transition_in);
+	bfree(override->transition_out);
+	bfree(override);
+}
+
+struct move_override *move_filter_get_override(obs_source_t *filter)
+{
+	struct move_filter_info *move_filter = obs_obj_get_data(filter);
+	if (!move_filter)
+		return NULL;
+	pthread_mutex_lock(&move_filter->override_mutex);
+	struct move_override *override = move_filter->override;
+	if (override)
+		os_atomic_inc_long(&override->refs);
+	pthread_mutex_unlock(&move_filter->override_mutex);
+	return override;
+}
+
+static void move_filter_changed(void *data, calldata_t *call_data)
+{
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(call_data);
+	move_transition_plans_invalidate();
+}
+
+static void move_filter_source_rename(void *data, const char *prev_name,
+				      const char *new_name);
+
+static void move_filter_update(void *data, obs_data_t *settings)
+{
+	struct move_filter_info *move_filter = data;
+	struct move_override *override = move_override_create(settings);
+	// a NULL name would listen to every rename
+	if (override->source_name)
+		move_rename_subscribe(move_filter, override->source_name,
+				      move_filter_source_rename);
+	else
+		move_rename_unsubscribe(move_filter);
+	pthread_mutex_lock(&move_filter->override_mutex);
+	struct move_override *old_override = move_filter->override;
+	move_filter->override = override;
+	pthread_mutex_unlock(&move_filter->override_mutex);
+	move_override_release(old_override);
+	move_transition_plans_invalidate();
+}
+
+static void move_filter_source_rename(void *data, const char *prev_name,
+				      const char *new_name)
 {
 	struct move_filter_info *move_filter = data;
-	const char *new_name = calldata_string(call_data, "new_name");
-	const char *prev_name = calldata_string(call_data, "prev_name");
 	obs_data_t *settings = obs_source_get_settings(move_filter->source);
-	if (!settings || !new_name || !prev_name)
+	if (!settings)
 		return;
 	const char *source_name = obs_data_get_string(settings, S_SOURCE);
 	if (source_name && strlen(source_name) &&
 	    strcmp(source_name, prev_name) == 0) {
 		obs_data_set_string(settings, S_SOURCE, new_name);
+		move_filter_update(move_filter, settings);
 	}
 	obs_data_release(settings);
 }
@@ -26,20 +129,41 @@ static void *move_filter_create(obs_data_t *settings, obs_source_t *source)
 	struct move_filter_info *move_filter =
 		bzalloc(sizeof(struct move_filter_info));
 	move_filter->source = source;
-	signal_handler_connect(obs_get_signal_handler(), "source_rename",
-			       move_filter_source_rename, move_filter);
-	UNUSED_PARAMETER(settings);
+	pthread_mutex_init(&move_filter->override_mutex, NULL);
+	signal_handler_connect(obs_source_get_signal_handler(source), "enable",
+			       move_filter_changed, move_filter);
+	move_filter_update(move_filter, settings);
 	return move_filter;
 }
 
 static void move_filter_destroy(void *data)
 {
 	struct move_filter_info *move_filter = data;
-	signal_handler_disconnect(obs_get_signal_handler(), "source_rename",
-				  move_filter_source_rename, move_filter);
+	move_rename_unsubscribe(move_filter);
+	signal_handler_disconnect(
+		obs_source_get_signal_handler(move_filter->source), "enable",
+		move_filter_changed, move_filter);
+	move_transition_plans_invalidate();
+	move_override_release(move_filter->override);
+	pthread_mutex_destroy(&move_filter->override_mutex);
 	bfree(move_filter);
 }
 
+// the first override filter of a source wins, so the order matters too
+static void move_filter_add(void *data, obs_source_t *parent)
+{
+	signal_handler_connect(obs_source_get_signal_handler(parent),
+			       "reorder_filters", move_filter_changed, data);
+	move_transition_plans_invalidate();
+}
+
+static void move_filter_remove(void *data, obs_source_t *parent)
+{
+	signal_handler_disconnect(obs_source_get_signal_handler(parent),
+				  "reorder_filters", move_filter_changed, data);
+	move_transition_plans_invalidate();
+}
+
 void prop_list_add_easings(obs_property_t *p);
 void prop_list_add_easing_functions(obs_property_t *p);
 void prop_list_add_positions(obs_property_t *p);
@@ -289,4 +413,7 @@ struct obs_source_info move_transition_override_filter = {
 	.destroy = move_filter_destroy,
 	.get_properties = move_filter_properties,
 	.get_defaults = move_filter_defaults,
+	.update = move_filter_update,
+	.filter_add = move_filter_add,
+	.filter_remove = move_filter_remove,
 	.video_render = move_filter_video_render};
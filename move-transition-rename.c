@@ -0,0 +1,114 @@
+#include "move-transition.h"
+#include <util/threading.h>
+
+struct move_rename_subscriber {
+	char *name;
+	move_rename_cb cb;
+	void *data;
+};
+
+// recursive so callbacks can subscribe again and destroy waits for them
+static pthread_mutex_t rename_mutex;
+// sorted by name
+static DARRAY(struct move_rename_subscriber) rename_subscribers;
+static DARRAY(struct move_rename_subscriber) rename_listeners;
+
+static size_t move_rename_lower_bound(const char *name)
+{
+	size_t lo = 0;
+	size_t hi = rename_subscribers.num;
+	while (lo < hi) {
+		const size_t mid = lo + ((hi - lo) >> 1);
+		if (strcmp(rename_subscribers.array[mid].name, name) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static void move_rename_remove(void *data)
+{
+	for (size_t i = 0; i < rename_subscribers.num; i++) {
+		if (rename_subscribers.array[i].data == data) {
+			bfree(rename_subscribers.array[i].name);
+			da_erase(rename_subscribers, i);
+			return;
+		}
+	}
+	for (size_t i = 0; i < rename_listeners.num; i++) {
+		if (rename_listeners.array[i].data == data) {
+			da_erase(rename_listeners, i);
+			return;
+		}
+	}
+}
+
+void move_rename_subscribe(void *data, const char *name, move_rename_cb cb)
+{
+	pthread_mutex_lock(&rename_mutex);
+	move_rename_remove(data);
+	struct move_rename_subscriber subscriber = {NULL, cb, data};
+	if (!name) {
+		da_push_back(rename_listeners, &subscriber);
+	} else if (strlen(name)) {
+		subscriber.name = bstrdup(name);
+		da_insert(rename_subscribers, move_rename_lower_bound(name),
+			  &subscriber);
+	}
+	pthread_mutex_unlock(&rename_mutex);
+}
+
+void move_rename_unsubscribe(void *data)
+{
+	pthread_mutex_lock(&rename_mutex);
+	move_rename_remove(data);
+	pthread_mutex_unlock(&rename_mutex);
+}
+
+static void move_rename_signal(void *data, calldata_t *call_data)
+{
+	UNUSED_PARAMETER(data);
+	const char *new_name = calldata_string(call_data, "new_name");
+	const char *prev_name = calldata_string(call_data, "prev_name");
+	if (!new_name || !prev_name)
+		return;
+
+	pthread_mutex_lock(&rename_mutex);
+	// callbacks may change the subscriptions, so call from a copy
+	DARRAY(struct move_rename_subscriber) calls;
+	da_init(calls);
+	da_push_back_array(calls, rename_listeners.array,
+			   rename_listeners.num);
+	for (size_t i = move_rename_lower_bound(prev_name);
+	     i < rename_subscribers.num &&
+	     strcmp(rename_subscribers.array[i].name, prev_name) == 0;
+	     i++)
+		da_push_back(calls, &rename_subscribers.array[i]);
+	for (size_t i = 0; i < calls.num; i++)
+		calls.array[i].cb(calls.array[i].data, prev_name, new_name);
+	pthread_mutex_unlock(&rename_mutex);
+	da_free(calls);
+}
+
+void move_rename_init(void)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&rename_mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+	signal_handler_connect(obs_get_signal_handler(), "source_rename",
+			       move_rename_signal, NULL);
+}
+
+void move_rename_free(void)
+{
+	signal_handler_disconnect(obs_get_signal_handler(), "source_rename",
+				  move_rename_signal, NULL);
+	for (size_t i = 0; i < rename_subscribers.num; i++)
+		bfree(rename_subscribers.array[i].name);
+	da_free(rename_subscribers);
+	da_free(rename_listeners);
+	pthread_mutex_destroy(&rename_mutex);
+}
@@ -0,0 +1,139 @@
+#include "move-transition.h"
+#include <util/threading.h>
+
+struct move_animation {
+	obs_weak_source_t *source;
+	void *data;
+	move_animation_tick_cb tick;
+	bool queued;
+};
+
+struct move_animation_tick {
+	obs_source_t *source;
+	void *data;
+	move_animation_tick_cb tick;
+	bool active;
+};
+
+static pthread_mutex_t animations_mutex;
+static DARRAY(struct move_animation) animations;
+// only used from the video thread
+static DARRAY(struct move_animation_tick) animation_ticks;
+static DARRAY(obs_source_t *) animation_updates;
+
+static size_t move_animation_find(void *data)
+{
+	for (size_t i = 0; i < animations.num; i++) {
+		if (animations.array[i].data == data)
+			return i;
+	}
+	return DARRAY_INVALID;
+}
+
+void move_animation_queue(obs_source_t *source, void *data,
+			  move_animation_tick_cb tick)
+{
+	pthread_mutex_lock(&animations_mutex);
+	size_t i = move_animation_find(data);
+	if (i == DARRAY_INVALID) {
+		struct move_animation *animation =
+			da_push_back_new(animations);
+		animation->source = obs_source_get_weak_source(source);
+		animation->data = data;
+		animation->tick = tick;
+		i = animations.num - 1;
+	}
+	animations.array[i].queued = true;
+	pthread_mutex_unlock(&animations_mutex);
+}
+
+void move_animation_remove(void *data)
+{
+	pthread_mutex_lock(&animations_mutex);
+	const size_t i = move_animation_find(data);
+	if (i != DARRAY_INVALID) {
+		obs_weak_source_release(animations.array[i].source);
+		da_erase(animations, i);
+	}
+	pthread_mutex_unlock(&animations_mutex);
+}
+
+// settings written by ticks are applied with one update per source after
+// all ticks ran, only to be called from a tick
+void move_animation_update(obs_source_t *source)
+{
+	if (!source)
+		return;
+	for (size_t i = 0; i < animation_updates.num; i++) {
+		if (animation_updates.array[i] == source)
+			return;
+	}
+	obs_source_addref(source);
+	da_push_back(animation_updates, &source);
+}
+
+static void move_scheduler_tick(void *param, float seconds)
+{
+	UNUSED_PARAMETER(param);
+	animation_ticks.num = 0;
+	pthread_mutex_lock(&animations_mutex);
+	for (size_t i = 0; i < animations.num; i++) {
+		struct move_animation *animation = &animations.array[i];
+		// a filter that is being destroyed has no strong ref left
+		obs_source_t *source =
+			obs_weak_source_get_source(animation->source);
+		if (!source)
+			continue;
+		animation->queued = false;
+		struct move_animation_tick *tick =
+			da_push_back_new(animation_ticks);
+		tick->source = source;
+		tick->data = animation->data;
+		tick->tick = animation->tick;
+	}
+	pthread_mutex_unlock(&animations_mutex);
+
+	// ticks run unlocked, they start other filters that queue themselves
+	for (size_t i = 0; i < animation_ticks.num; i++) {
+		struct move_animation_tick *tick = &animation_ticks.array[i];
+		tick->active = tick->tick(tick->data, seconds);
+	}
+	for (size_t i = 0; i < animation_updates.num; i++) {
+		obs_source_update(animation_updates.array[i], NULL);
+		obs_source_release(animation_updates.array[i]);
+	}
+	animation_updates.num = 0;
+
+	pthread_mutex_lock(&animations_mutex);
+	for (size_t i = 0; i < animation_ticks.num; i++) {
+		struct move_animation_tick *tick = &animation_ticks.array[i];
+		if (tick->active)
+			continue;
+		const size_t j = move_animation_find(tick->data);
+		if (j != DARRAY_INVALID && !animations.array[j].queued) {
+			obs_weak_source_release(animations.array[j].source);
+			da_erase(animations, j);
+		}
+	}
+	pthread_mutex_unlock(&animations_mutex);
+
+	for (size_t i = 0; i < animation_ticks.num; i++)
+		obs_source_release(animation_ticks.array[i].source);
+}
+
+void move_scheduler_init(void)
+{
+	pthread_mutex_init(&animations_mutex, NULL);
+	obs_add_tick_callback(move_scheduler_tick, NULL);
+}
+
+void move_scheduler_free(void)
+{
+	obs_remove_tick_callback(move_scheduler_tick, NULL);
+	for (size_t i = 0; i < animations.num; i++)
+		obs_weak_source_release(animations.array[i].source);
+	da_free(animations);
+	da_free(animation_ticks);
+	da_free(animation_updates);
+	pthread_mutex_destroy(&animations_mutex);
+}
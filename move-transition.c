@@ -4,19 +4,39 @@
 #include "../obs-transitions/easings.h"
 #include "graphics/math-defs.h"
 #include "graphics/matrix4.h"
+#include "util/threading.h"
+#include "util/platform.h"
 #include "easing.h"
 
+// render cost of the current or last run of the transition
+struct move_stats {
+	uint64_t match_ns;
+	long match_allocs;
+	uint64_t setup_ns;
+	uint64_t interpolate_ns;
+	uint64_t interpolate_ns_max;
+	uint64_t frames;
+	uint64_t slow_frames;
+	uint64_t frame_ns;
+	uint64_t frame_ns_max;
+	uint64_t items;
+	uint64_t item_ns;
+	uint64_t item_ns_max;
+	uint64_t offscreen_passes;
+};
+
 struct move_info {
 	obs_source_t *source;
 	bool start_init;
-	DARRAY(struct move_item *) items_a;
-	DARRAY(struct move_item *) items_b;
+	struct move_plan *plan;
+	struct move_plan *pending_plan;
+	// last destroyed plan, kept so the next one reuses its memory
+	struct move_plan *spare_plan;
+	pthread_mutex_t plan_mutex;
 	float t;
 	float curve_move;
 	float curve_in;
 	float curve_out;
-	obs_source_t *scene_source_a;
-	obs_source_t *scene_source_b;
 	gs_samplerstate_t *point_sampler;
 	long long easing_move;
 	long long easing_in;
@@ -35,91 +55,631 @@ struct move_info {
 	bool number_match;
 	bool last_word_match;
 	enum obs_transition_scale_type transition_move_scale;
-	size_t item_pos;
-	uint32_t matched_items;
-	bool matched_scene_a;
-	bool matched_scene_b;
 	uint32_t item_order_switch_percentage;
 	bool cache_transitions;
+	volatile long generation;
 	DARRAY(obs_source_t *) transition_pool_move;
 	size_t transition_pool_move_index;
 	DARRAY(obs_source_t *) transition_pool_in;
 	size_t transition_pool_in_index;
 	DARRAY(obs_source_t *) transition_pool_out;
 	size_t transition_pool_out_index;
+	volatile long transition_pool_hits;
+	volatile long transition_pool_misses;
+	pthread_mutex_t stats_mutex;
+	struct move_stats stats;
+	// only used by the graphics thread
+	uint64_t frame_offscreen_passes;
+	bool log_render_stats;
+};
+
+// an item that goes right before the item at pos of the other order
+struct move_order_insert {
+	struct move_item *item;
+	size_t pos;
+};
+
+#define MOVE_ITEM_BLOCK 64
+#define MOVE_PLAN_NAMES_MAX 32
+
+struct move_scene_overrides {
+	obs_scene_t *scene;
+	struct match_index index;
+	DARRAY(struct move_override *) overrides;
+};
+
+struct move_plan_scene_item {
+	obs_sceneitem_t *item;
+	int64_t id;
+	// matching only pairs items that both have bounds or both have none
+	bool bounds;
 };
 
-struct move_item {
-	obs_sceneitem_t *item_a;
-	obs_sceneitem_t *item_b;
-	gs_texrender_t *item_render;
-	obs_source_t *transition;
-	long long easing;
-	long long easing_function;
-	bool zoom;
-	long long position;
-	char *transition_name;
-	enum obs_transition_scale_type transition_scale;
-	float curve;
-	bool move_scene;
-	int start_percentage;
-	int end_percentage;
+struct move_plan {
+	struct move_info *move;
+	// only held while attached, the weak refs recognise the scenes after
+	obs_source_t *scene_source_a;
+	obs_source_t *scene_source_b;
+	obs_weak_source_t *weak_source_a;
+	obs_weak_source_t *weak_source_b;
+	// visible items of scene a and then scene b in scene order, the plan
+	// holds a ref on each of them while attached
+	DARRAY(struct move_plan_scene_item) scene_items;
+	size_t scene_items_a;
+	bool attached;
+	DARRAY(struct move_item *) items_a;
+	DARRAY(struct move_item *) items_b;
+	// items are carved from blocks that are kept when the plan is reused
+	DARRAY(struct move_item *) item_blocks;
+	size_t items_used;
+	// transition names of the items
+	DARRAY(char *) names;
+	DARRAY(struct move_order_insert) inserts;
+	DARRAY(struct move_item *) order;
+	struct match_index match_index;
+	struct move_scene_overrides overrides_a;
+	struct move_scene_overrides overrides_b;
+	struct move_snapshot snapshot;
+	struct move_frame frame;
+	size_t item_pos;
+	uint32_t matched_items;
+	bool matched_scene_a;
+	bool matched_scene_b;
+	bool reusable;
+	long generation;
+	long global_generation;
+	volatile long changes;
+	uint64_t create_ns;
+	long create_allocs;
+};
+
+static volatile long move_plans_generation = 0;
+
+void move_transition_plans_invalidate(void)
+{
+	os_atomic_inc_long(&move_plans_generation);
+}
+
+static void move_plans_source_rename(void *data, const char *prev_name,
+				     const char *new_name)
+{
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(prev_name);
+	UNUSED_PARAMETER(new_name);
+	move_transition_plans_invalidate();
+}
+
+#define TEXRENDER_POOL_MAX 32
+
+struct texrender_pool_entry {
+	gs_texrender_t *texrender;
+	uint32_t cx;
+	uint32_t cy;
 };
 
+// only used inside the graphics context, which serializes access
+static DARRAY(struct texrender_pool_entry) texrender_pool = {0};
+static volatile long texrender_pool_hits = 0;
+static volatile long texrender_pool_resizes = 0;
+static volatile long texrender_pool_misses = 0;
+
+static gs_texrender_t *texrender_pool_acquire(uint32_t cx, uint32_t cy)
+{
+	size_t found = texrender_pool.num;
+	for (size_t i = 0; i < texrender_pool.num; i++) {
+		if (texrender_pool.array[i].cx == cx &&
+		    texrender_pool.array[i].cy == cy) {
+			found = i;
+			break;
+		}
+	}
+	if (found < texrender_pool.num) {
+		os_atomic_inc_long(&texrender_pool_hits);
+	} else if (texrender_pool.num) {
+		// a target of another size still saves the texrender itself,
+		// its texture gets reallocated on the next begin
+		os_atomic_inc_long(&texrender_pool_resizes);
+		found = texrender_pool.num - 1;
+	} else {
+		os_atomic_inc_long(&texrender_pool_misses);
+		return gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	}
+	gs_texrender_t *texrender = texrender_pool.array[found].texrender;
+	da_erase(texrender_pool, found);
+	gs_texrender_reset(texrender);
+	return texrender;
+}
+
+static void texrender_pool_release(gs_texrender_t *texrender)
+{
+	if (!texrender)
+		return;
+	if (texrender_pool.num >= TEXRENDER_POOL_MAX) {
+		gs_texrender_destroy(texrender);
+		return;
+	}
+	struct texrender_pool_entry *entry = da_push_back_new(texrender_pool);
+	entry->texrender = texrender;
+	gs_texture_t *tex = gs_texrender_get_texture(texrender);
+	entry->cx = tex ? gs_texture_get_width(tex) : 0;
+	entry->cy = tex ? gs_texture_get_height(tex) : 0;
+}
+
+static void texrender_pool_free(void)
+{
+	obs_enter_graphics();
+	for (size_t i = 0; i < texrender_pool.num; i++)
+		gs_texrender_destroy(texrender_pool.array[i].texrender);
+	obs_leave_graphics();
+	da_free(texrender_pool);
+	blog(LOG_INFO,
+	     "[move-transition] texrender pool: %ld hits, %ld resizes, "
+	     "%ld misses",
+	     texrender_pool_hits, texrender_pool_resizes,
+	     texrender_pool_misses);
+}
+
 static const char *move_get_name(void *type_data)
 {
 	UNUSED_PARAMETER(type_data);
 	return obs_module_text("Move");
 }
 
-static void *move_create(obs_data_t *settings, obs_source_t *source)
+static void move_plan_scene_changed(void *data, calldata_t *call_data)
 {
-	struct move_info *move = bzalloc(sizeof(struct move_info));
-	move->source = source;
-	da_init(move->items_a);
-	da_init(move->items_b);
-	da_init(move->transition_pool_out);
-	da_init(move->transition_pool_in);
-	da_init(move->transition_pool_out);
-	obs_source_update(source, settings);
-	return move;
+	UNUSED_PARAMETER(call_data);
+	struct move_plan *plan = data;
+	os_atomic_inc_long(&plan->changes);
 }
 
-static void clear_items(struct move_info *move, bool in_graphics)
+static const char *scene_change_signals[] = {
+	"item_add",       "item_remove",     "reorder",
+	"refresh",        "item_visible",    "item_transform",
+	"reorder_filters", NULL};
+
+static void scene_signals_connect(struct move_plan *plan,
+				  obs_source_t *scene_source, bool connect)
+{
+	if (!scene_source)
+		return;
+	signal_handler_t *sh = obs_source_get_signal_handler(scene_source);
+	if (!sh)
+		return;
+	for (size_t i = 0; scene_change_signals[i]; i++) {
+		if (connect)
+			signal_handler_connect(sh, scene_change_signals[i],
+					       move_plan_scene_changed, plan);
+		else
+			signal_handler_disconnect(sh, scene_change_signals[i],
+						  move_plan_scene_changed,
+						  plan);
+	}
+}
+
+static bool move_plan_scene_is(obs_weak_source_t *weak, obs_source_t *scene)
+{
+	return weak ? obs_weak_source_references_source(weak, scene) : !scene;
+}
+
+// built for these scenes and nothing changed since
+static bool move_plan_current(struct move_info *move, struct move_plan *plan,
+			      obs_source_t *scene_a, obs_source_t *scene_b)
+{
+	return plan && move_plan_scene_is(plan->weak_source_a, scene_a) &&
+	       move_plan_scene_is(plan->weak_source_b, scene_b) &&
+	       !os_atomic_load_long(&plan->changes) &&
+	       plan->generation == os_atomic_load_long(&move->generation) &&
+	       plan->global_generation ==
+		       os_atomic_load_long(&move_plans_generation);
+}
+
+static bool move_plan_valid(struct move_info *move, struct move_plan *plan,
+			    obs_source_t *scene_a, obs_source_t *scene_b)
+{
+	return plan && plan->reusable &&
+	       move_plan_current(move, plan, scene_a, scene_b);
+}
+
+static void clear_item_transitions(struct move_plan *plan, bool in_graphics)
 {
 	bool graphics = false;
-	for (size_t i = 0; i < move->items_a.num; i++) {
-		struct move_item *item = move->items_a.array[i];
+	for (size_t i = 0; i < plan->items_a.num; i++) {
+		struct move_item *item = plan->items_a.array[i];
 		if (item->item_render) {
 			if (!graphics && !in_graphics) {
 				obs_enter_graphics();
 				graphics = true;
 			}
-			gs_texrender_destroy(item->item_render);
+			texrender_pool_release(item->item_render);
 			item->item_render = NULL;
 		}
 	}
 	if (graphics)
 		obs_leave_graphics();
 
-	for (size_t i = 0; i < move->items_a.num; i++) {
-		struct move_item *item = move->items_a.array[i];
-		obs_sceneitem_release(item->item_a);
-		item->item_a = NULL;
-		obs_sceneitem_release(item->item_b);
-		item->item_b = NULL;
-
+	for (size_t i = 0; i < plan->items_a.num; i++) {
+		struct move_item *item = plan->items_a.array[i];
 		if (item->transition) {
 			obs_transition_force_stop(item->transition);
 			obs_transition_clear(item->transition);
 			obs_source_release(item->transition);
 			item->transition = NULL;
 		}
-		bfree(item->transition_name);
-		bfree(item);
 	}
-	move->items_a.num = 0;
-	move->items_b.num = 0;
+}
+
+static void scene_overrides_clear(struct move_scene_overrides *overrides)
+{
+	for (size_t i = 0; i < overrides->overrides.num; i++)
+		move_override_release(overrides->overrides.array[i]);
+	overrides->overrides.num = 0;
+	match_index_clear(&overrides->index);
+	overrides->scene = NULL;
+}
+
+static void move_plan_names_clear(struct move_plan *plan)
+{
+	for (size_t i = 0; i < plan->names.num; i++)
+		bfree(plan->names.array[i]);
+	plan->names.num = 0;
+}
+
+static const char *move_plan_intern(struct move_plan *plan, const char *name)
+{
+	for (size_t i = 0; i < plan->names.num; i++) {
+		if (strcmp(plan->names.array[i], name) == 0)
+			return plan->names.array[i];
+	}
+	char *copy = bstrdup(name);
+	da_push_back(plan->names, &copy);
+	return copy;
+}
+
+// drops the refs on the scenes and their items, the pointers are only kept
+// to recognise them when the plan is attached again
+static void move_plan_release_refs(struct move_plan *plan)
+{
+	if (!plan->attached)
+		return;
+	scene_signals_connect(plan, plan->scene_source_a, false);
+	scene_signals_connect(plan, plan->scene_source_b, false);
+	for (size_t i = 0; i < plan->scene_items.num; i++)
+		obs_sceneitem_release(plan->scene_items.array[i].item);
+	obs_source_release(plan->scene_source_a);
+	obs_source_release(plan->scene_source_b);
+	plan->scene_source_a = NULL;
+	plan->scene_source_b = NULL;
+	plan->attached = false;
+}
+
+// after a transition the plan keeps nothing alive that the user removes
+static void move_plan_detach(struct move_plan *plan, bool in_graphics)
+{
+	if (!plan || !plan->attached)
+		return;
+	clear_item_transitions(plan, in_graphics);
+	move_plan_release_refs(plan);
+}
+
+struct move_plan_attach {
+	struct move_plan *plan;
+	size_t pos;
+	size_t end;
+	bool match;
+};
+
+static bool move_plan_attach_item(obs_scene_t *scene,
+				  obs_sceneitem_t *scene_item, void *data)
+{
+	UNUSED_PARAMETER(scene);
+	if (!obs_sceneitem_visible(scene_item))
+		return true;
+	struct move_plan_attach *attach = data;
+	struct move_plan_scene_item *known =
+		&attach->plan->scene_items.array[attach->pos];
+	// the id tells a new item apart from a removed one at the same address,
+	// transforms are not watched while detached so recheck what matching
+	// reads from them
+	if (attach->pos == attach->end || known->item != scene_item ||
+	    known->id != obs_sceneitem_get_id(scene_item) ||
+	    known->bounds != (obs_sceneitem_get_bounds_type(scene_item) !=
+			      OBS_BOUNDS_NONE)) {
+		attach->match = false;
+		return false;
+	}
+	obs_sceneitem_addref(scene_item);
+	attach->pos++;
+	return true;
+}
+
+// takes the refs again when both scenes still have exactly the same visible
+// items in the same order, matched the same way
+static bool move_plan_attach(struct move_plan *plan, obs_source_t *scene_a,
+			     obs_source_t *scene_b)
+{
+	if (plan->attached)
+		return false;
+	struct move_plan_attach attach = {plan, 0, plan->scene_items_a, true};
+	obs_scene_enum_items(obs_scene_from_source(scene_a),
+			     move_plan_attach_item, &attach);
+	if (attach.match && attach.pos == attach.end) {
+		attach.end = plan->scene_items.num;
+		obs_scene_enum_items(obs_scene_from_source(scene_b),
+				     move_plan_attach_item, &attach);
+	}
+	if (!attach.match || attach.pos != plan->scene_items.num) {
+		for (size_t i = 0; i < attach.pos; i++)
+			obs_sceneitem_release(plan->scene_items.array[i].item);
+		return false;
+	}
+	obs_source_addref(scene_a);
+	obs_source_addref(scene_b);
+	plan->scene_source_a = scene_a;
+	plan->scene_source_b = scene_b;
+	scene_signals_connect(plan, scene_a, true);
+	scene_signals_connect(plan, scene_b, true);
+	plan->attached = true;
+	return true;
+}
+
+// releases everything the plan references but keeps its memory
+static void move_plan_reset(struct move_plan *plan, bool in_graphics)
+{
+	clear_item_transitions(plan, in_graphics);
+	move_plan_release_refs(plan);
+	plan->scene_items.num = 0;
+	plan->scene_items_a = 0;
+	obs_weak_source_release(plan->weak_source_a);
+	obs_weak_source_release(plan->weak_source_b);
+	plan->weak_source_a = NULL;
+	plan->weak_source_b = NULL;
+	plan->items_used = 0;
+	plan->items_a.num = 0;
+	plan->items_b.num = 0;
+	plan->inserts.num = 0;
+	plan->order.num = 0;
+	// names are only shared between the items, keep the usual few
+	if (plan->names.num > MOVE_PLAN_NAMES_MAX)
+		move_plan_names_clear(plan);
+	match_index_clear(&plan->match_index);
+	scene_overrides_clear(&plan->overrides_a);
+	scene_overrides_clear(&plan->overrides_b);
+	plan->frame.ease.num = 0;
+	plan->frame.layouts.num = 0;
+	plan->item_pos = 0;
+	plan->matched_items = 0;
+	plan->matched_scene_a = false;
+	plan->matched_scene_b = false;
+	plan->reusable = false;
+	plan->changes = 0;
+}
+
+static void move_plan_free(struct move_plan *plan)
+{
+	for (size_t i = 0; i < plan->item_blocks.num; i++)
+		bfree(plan->item_blocks.array[i]);
+	da_free(plan->item_blocks);
+	da_free(plan->scene_items);
+	da_free(plan->items_a);
+	da_free(plan->items_b);
+	da_free(plan->inserts);
+	da_free(plan->order);
+	move_plan_names_clear(plan);
+	da_free(plan->names);
+	match_index_free(&plan->match_index);
+	match_index_free(&plan->overrides_a.index);
+	match_index_free(&plan->overrides_b.index);
+	da_free(plan->overrides_a.overrides);
+	da_free(plan->overrides_b.overrides);
+	bfree(plan->snapshot.data);
+	bfree(plan->frame.data);
+	da_free(plan->frame.ease);
+	da_free(plan->frame.layouts);
+	bfree(plan);
+}
+
+static void move_plan_destroy(struct move_plan *plan, bool in_graphics)
+{
+	if (!plan)
+		return;
+	move_plan_reset(plan, in_graphics);
+	move_plan_free(plan);
+}
+
+// keeps the plan as the spare of the transition when there is none yet
+static void move_plan_recycle(struct move_info *move, struct move_plan *plan,
+			      bool in_graphics)
+{
+	if (!plan)
+		return;
+	move_plan_reset(plan, in_graphics);
+	pthread_mutex_lock(&move->plan_mutex);
+	if (!move->spare_plan) {
+		move->spare_plan = plan;
+		plan = NULL;
+	}
+	pthread_mutex_unlock(&move->plan_mutex);
+	if (plan)
+		move_plan_free(plan);
+}
+
+static struct move_plan *move_plan_create(struct move_info *move,
+					  obs_source_t *scene_a,
+					  obs_source_t *scene_b);
+
+static void move_transition_started(void *data, calldata_t *call_data)
+{
+	UNUSED_PARAMETER(call_data);
+	struct move_info *move = data;
+	obs_source_t *scene_a =
+		obs_transition_get_source(move->source, OBS_TRANSITION_SOURCE_A);
+	obs_source_t *scene_b =
+		obs_transition_get_source(move->source, OBS_TRANSITION_SOURCE_B);
+	struct move_plan *old_plan = NULL;
+	pthread_mutex_lock(&move->plan_mutex);
+	if (!move_plan_valid(move, move->pending_plan, scene_a, scene_b) &&
+	    !move_plan_valid(move, move->plan, scene_a, scene_b)) {
+		old_plan = move->pending_plan;
+		move->pending_plan = move_plan_create(move, scene_a, scene_b);
+		scene_a = NULL;
+		scene_b = NULL;
+	}
+	pthread_mutex_unlock(&move->plan_mutex);
+	obs_source_release(scene_a);
+	obs_source_release(scene_b);
+	move_plan_recycle(move, old_plan, false);
+}
+
+static void move_get_render_stats(void *data, calldata_t *call_data)
+{
+	struct move_info *move = data;
+	pthread_mutex_lock(&move->stats_mutex);
+	const struct move_stats stats = move->stats;
+	pthread_mutex_unlock(&move->stats_mutex);
+	calldata_set_int(call_data, "match_ns", (long long)stats.match_ns);
+	calldata_set_int(call_data, "match_allocs", stats.match_allocs);
+	calldata_set_int(call_data, "setup_ns", (long long)stats.setup_ns);
+	calldata_set_int(call_data, "interpolate_ns",
+			 (long long)stats.interpolate_ns);
+	calldata_set_int(call_data, "interpolate_ns_max",
+			 (long long)stats.interpolate_ns_max);
+	calldata_set_int(call_data, "frames", (long long)stats.frames);
+	calldata_set_int(call_data, "slow_frames",
+			 (long long)stats.slow_frames);
+	calldata_set_int(call_data, "frame_ns", (long long)stats.frame_ns);
+	calldata_set_int(call_data, "frame_ns_max",
+			 (long long)stats.frame_ns_max);
+	calldata_set_int(call_data, "items", (long long)stats.items);
+	calldata_set_int(call_data, "item_ns", (long long)stats.item_ns);
+	calldata_set_int(call_data, "item_ns_max",
+			 (long long)stats.item_ns_max);
+	calldata_set_int(call_data, "offscreen_passes",
+			 (long long)stats.offscreen_passes);
+	calldata_set_int(call_data, "transition_pool_hits",
+			 os_atomic_load_long(&move->transition_pool_hits));
+	calldata_set_int(call_data, "transition_pool_misses",
+			 os_atomic_load_long(&move->transition_pool_misses));
+	calldata_set_int(call_data, "texrender_pool_hits",
+			 os_atomic_load_long(&texrender_pool_hits));
+	calldata_set_int(call_data, "texrender_pool_resizes",
+			 os_atomic_load_long(&texrender_pool_resizes));
+	calldata_set_int(call_data, "texrender_pool_misses",
+			 os_atomic_load_long(&texrender_pool_misses));
+}
+
+static void move_item_layout_add(struct move_info *move,
+				 struct move_plan *plan, struct move_item *item,
+				 obs_data_array_t *items)
+{
+	struct move_item_layout *layout =
+		&plan->frame.layouts.array[item->snapshot_index];
+	obs_data_t *data = obs_data_create();
+	obs_source_t *source =
+		obs_sceneitem_get_source(move_item_scene_item(move->t, item));
+	obs_data_set_string(data, "name", obs_source_get_name(source));
+	obs_data_set_vec4(data, "transform_x", &layout->draw_transform.x);
+	obs_data_set_vec4(data, "transform_y", &layout->draw_transform.y);
+	obs_data_set_vec4(data, "transform_z", &layout->draw_transform.z);
+	obs_data_set_vec4(data, "transform_t", &layout->draw_transform.t);
+	obs_data_set_int(data, "crop_left", layout->crop.left);
+	obs_data_set_int(data, "crop_top", layout->crop.top);
+	obs_data_set_int(data, "crop_right", layout->crop.right);
+	obs_data_set_int(data, "crop_bottom", layout->crop.bottom);
+	obs_data_set_vec2(data, "output_scale", &layout->output_scale);
+	obs_data_set_int(data, "width", layout->width);
+	obs_data_set_int(data, "height", layout->height);
+	obs_data_array_push_back(items, data);
+	obs_data_release(data);
+}
+
+// geometry of the last rendered frame, to compare renders between builds
+static void move_get_item_layouts(void *data, calldata_t *call_data)
+{
+	struct move_info *move = data;
+	obs_data_t *layouts = obs_data_create();
+	obs_data_array_t *items = obs_data_array_create();
+	// the graphics context keeps the render from changing the plan
+	obs_enter_graphics();
+	struct move_plan *plan = move->plan;
+	if (plan && plan->attached && plan->frame.layouts.num) {
+		obs_data_set_double(layouts, "t", move->t);
+		if (move->t * 100.0 < move->item_order_switch_percentage) {
+			for (size_t i = 0; i < plan->items_a.num; i++)
+				move_item_layout_add(move, plan,
+						     plan->items_a.array[i],
+						     items);
+		} else {
+			for (size_t i = 0; i < plan->items_b.num; i++)
+				move_item_layout_add(move, plan,
+						     plan->items_b.array[i],
+						     items);
+		}
+	}
+	obs_leave_graphics();
+	obs_data_set_array(layouts, "items", items);
+	obs_data_array_release(items);
+	calldata_set_string(call_data, "layouts", obs_data_get_json(layouts));
+	obs_data_release(layouts);
+}
+
+static void move_log_render_stats(struct move_info *move)
+{
+	pthread_mutex_lock(&move->stats_mutex);
+	const struct move_stats stats = move->stats;
+	pthread_mutex_unlock(&move->stats_mutex);
+	if (!stats.frames)
+		return;
+	blog(LOG_INFO,
+	     "[move-transition] '%s' matching %.2f ms (%ld allocations), "
+	     "setup %.2f ms, interpolation avg %.3f ms max %.3f ms, "
+	     "%llu frames avg %.2f ms max %.2f ms (%llu over budget), "
+	     "%llu items avg %.3f ms max %.3f ms, %llu offscreen passes, "
+	     "transition pool %ld hits %ld misses",
+	     obs_source_get_name(move->source), stats.match_ns / 1000000.0,
+	     stats.match_allocs, stats.setup_ns / 1000000.0,
+	     stats.interpolate_ns / 1000000.0 / stats.frames,
+	     stats.interpolate_ns_max / 1000000.0,
+	     (unsigned long long)stats.frames,
+	     stats.frame_ns / 1000000.0 / stats.frames,
+	     stats.frame_ns_max / 1000000.0,
+	     (unsigned long long)stats.slow_frames,
+	     (unsigned long long)stats.items,
+	     stats.items ? stats.item_ns / 1000000.0 / stats.items : 0.0,
+	     stats.item_ns_max / 1000000.0,
+	     (unsigned long long)stats.offscreen_passes,
+	     os_atomic_load_long(&move->transition_pool_hits),
+	     os_atomic_load_long(&move->transition_pool_misses));
+}
+
+static void *move_create(obs_data_t *settings, obs_source_t *source)
+{
+	struct move_info *move = bzalloc(sizeof(struct move_info));
+	move->source = source;
+	pthread_mutex_init(&move->plan_mutex, NULL);
+	pthread_mutex_init(&move->stats_mutex, NULL);
+	da_init(move->transition_pool_out);
+	da_init(move->transition_pool_in);
+	da_init(move->transition_pool_out);
+	obs_source_update(source, settings);
+	signal_handler_connect(obs_source_get_signal_handler(source),
+			       "transition_start", move_transition_started,
+			       move);
+	proc_handler_add(
+		obs_source_get_proc_handler(source),
+		"void get_render_stats(out int match_ns, out int match_allocs, "
+		"out int setup_ns, out int interpolate_ns, "
+		"out int interpolate_ns_max, out int frames, "
+		"out int slow_frames, out int frame_ns, out int frame_ns_max, "
+		"out int items, out int item_ns, out int item_ns_max, "
+		"out int offscreen_passes, out int transition_pool_hits, "
+		"out int transition_pool_misses, out int texrender_pool_hits, "
+		"out int texrender_pool_resizes, "
+		"out int texrender_pool_misses)",
+		move_get_render_stats, move);
+	proc_handler_add(obs_source_get_proc_handler(source),
+			 "void get_item_layouts(out string layouts)",
+			 move_get_item_layouts, move);
+	return move;
 }
 
 void clear_transition_pool(void *data)
@@ -134,17 +694,20 @@ void clear_transition_pool(void *data)
 static void move_destroy(void *data)
 {
 	struct move_info *move = data;
-	clear_items(move, false);
-	da_free(move->items_a);
-	da_free(move->items_b);
+	signal_handler_disconnect(obs_source_get_signal_handler(move->source),
+				  "transition_start", move_transition_started,
+				  move);
+	move_plan_destroy(move->pending_plan, false);
+	move_plan_destroy(move->plan, false);
+	move_plan_destroy(move->spare_plan, false);
+	pthread_mutex_destroy(&move->plan_mutex);
+	pthread_mutex_destroy(&move->stats_mutex);
 	clear_transition_pool(&move->transition_pool_move);
 	da_free(move->transition_pool_move);
 	clear_transition_pool(&move->transition_pool_in);
 	da_free(move->transition_pool_in);
 	clear_transition_pool(&move->transition_pool_out);
 	da_free(move->transition_pool_out);
-	obs_source_release(move->scene_source_a);
-	obs_source_release(move->scene_source_b);
 	bfree(move->transition_in);
 	bfree(move->transition_out);
 	bfree(move->transition_move);
@@ -159,6 +722,7 @@ static void move_destroy(void *data)
 static void move_update(void *data, obs_data_t *settings)
 {
 	struct move_info *move = data;
+	os_atomic_inc_long(&move->generation);
 	move->easing_move = obs_data_get_int(settings, S_EASING_MATCH);
 	move->easing_in = obs_data_get_int(settings, S_EASING_IN);
 	move->easing_out = obs_data_get_int(settings, S_EASING_OUT);
@@ -212,122 +776,8 @@ static void move_update(void *data, obs_data_t *settings)
 		(uint32_t)obs_data_get_int(settings, S_SWITCH_PERCENTAGE);
 	move->cache_transitions =
 		obs_data_get_bool(settings, S_CACHE_TRANSITIONS);
-}
-
-void add_alignment(struct vec2 *v, uint32_t align, int cx, int cy)
-{
-	if (align & OBS_ALIGN_RIGHT)
-		v->x += (float)cx;
-	else if ((align & OBS_ALIGN_LEFT) == 0)
-		v->x += (float)(cx >> 1);
-
-	if (align & OBS_ALIGN_BOTTOM)
-		v->y += (float)cy;
-	else if ((align & OBS_ALIGN_TOP) == 0)
-		v->y += (float)(cy >> 1);
-}
-
-void add_move_alignment(struct vec2 *v, uint32_t align_a, uint32_t align_b,
-			float t, int cx, int cy)
-{
-	if (align_a & OBS_ALIGN_RIGHT)
-		v->x += (float)cx * (1.0f - t);
-	else if ((align_a & OBS_ALIGN_LEFT) == 0)
-		v->x += (float)(cx >> 1) * (1.0f - t);
-
-	if (align_a & OBS_ALIGN_BOTTOM)
-		v->y += (float)cy * (1.0f - t);
-	else if ((align_a & OBS_ALIGN_TOP) == 0)
-		v->y += (float)(cy >> 1) * (1.0f - t);
-
-	if (align_b & OBS_ALIGN_RIGHT)
-		v->x += (float)cx * t;
-	else if ((align_b & OBS_ALIGN_LEFT) == 0)
-		v->x += (float)(cx >> 1) * t;
-
-	if (align_b & OBS_ALIGN_BOTTOM)
-		v->y += (float)cy * t;
-	else if ((align_b & OBS_ALIGN_TOP) == 0)
-		v->y += (float)(cy >> 1) * t;
-}
-
-static void calculate_bounds_data(struct obs_scene_item *item,
-				  struct vec2 *origin, struct vec2 *scale,
-				  uint32_t *cx, uint32_t *cy,
-				  struct vec2 *bounds)
-{
-	float width = (float)(*cx) * fabsf(scale->x);
-	float height = (float)(*cy) * fabsf(scale->y);
-	const float item_aspect = width / height;
-	const float bounds_aspect = bounds->x / bounds->y;
-	uint32_t bounds_type = obs_sceneitem_get_bounds_type(item);
-
-	if (bounds_type == OBS_BOUNDS_MAX_ONLY)
-		if (width > bounds->x || height > bounds->y)
-			bounds_type = OBS_BOUNDS_SCALE_INNER;
-
-	if (bounds_type == OBS_BOUNDS_SCALE_INNER ||
-	    bounds_type == OBS_BOUNDS_SCALE_OUTER) {
-		bool use_width = (bounds_aspect < item_aspect);
-
-		if (obs_sceneitem_get_bounds_type(item) ==
-		    OBS_BOUNDS_SCALE_OUTER)
-			use_width = !use_width;
-
-		const float mul = use_width ? bounds->x / width
-					    : bounds->y / height;
-
-		vec2_mulf(scale, scale, mul);
-
-	} else if (bounds_type == OBS_BOUNDS_SCALE_TO_WIDTH) {
-		vec2_mulf(scale, scale, bounds->x / width);
-
-	} else if (bounds_type == OBS_BOUNDS_SCALE_TO_HEIGHT) {
-		vec2_mulf(scale, scale, bounds->y / height);
-
-	} else if (bounds_type == OBS_BOUNDS_STRETCH) {
-		scale->x = bounds->x / (float)(*cx);
-		scale->y = bounds->y / (float)(*cy);
-	}
-
-	width = (float)(*cx) * scale->x;
-	height = (float)(*cy) * scale->y;
-	const float width_diff = bounds->x - width;
-	const float height_diff = bounds->y - height;
-	*cx = (uint32_t)bounds->x;
-	*cy = (uint32_t)bounds->y;
-
-	add_alignment(origin, obs_sceneitem_get_bounds_alignment(item),
-		      (int)-width_diff, (int)-height_diff);
-}
-
-static void calculate_move_bounds_data(struct obs_scene_item *item_a,
-				       struct obs_scene_item *item_b, float t,
-				       struct vec2 *origin, struct vec2 *scale,
-				       uint32_t *cx, uint32_t *cy,
-				       struct vec2 *bounds)
-{
-	struct vec2 origin_a;
-	vec2_set(&origin_a, origin->x, origin->y);
-	struct vec2 origin_b;
-	vec2_set(&origin_b, origin->x, origin->y);
-
-	struct vec2 scale_a;
-	vec2_set(&scale_a, scale->x, scale->y);
-	struct vec2 scale_b;
-	vec2_set(&scale_b, scale->x, scale->y);
-	uint32_t cxa = *cx;
-	uint32_t cxb = *cx;
-	uint32_t cya = *cy;
-	uint32_t cyb = *cy;
-	calculate_bounds_data(item_a, &origin_a, &scale_a, &cxa, &cya, bounds);
-	calculate_bounds_data(item_b, &origin_b, &scale_b, &cxb, &cyb, bounds);
-	vec2_set(origin, origin_a.x * (1.0f - t) + origin_b.x * t,
-		 origin_a.y * (1.0f - t) + origin_b.y * t);
-	vec2_set(scale, scale_a.x * (1.0f - t) + scale_b.x * t,
-		 scale_a.y * (1.0f - t) + scale_b.y * t);
-	*cx = (uint32_t)((float)cxa * (1.0f - t) + (float)cxb * t);
-	*cy = (uint32_t)((float)cya * (1.0f - t) + (float)cyb * t);
+	move->log_render_stats =
+		obs_data_get_bool(settings, S_LOG_RENDER_STATS);
 }
 
 static inline bool item_is_scene(struct obs_scene_item *item)
@@ -346,205 +796,157 @@ static inline bool crop_enabled(const struct obs_sceneitem_crop *crop)
 	return crop->left || crop->right || crop->top || crop->bottom;
 }
 
-static inline bool item_texture_enabled(struct obs_scene_item *item)
+static inline bool item_is_nested_scene(struct obs_scene_item *item)
 {
-	if (!item)
-		false;
-	struct obs_sceneitem_crop crop;
-	obs_sceneitem_get_crop(item, &crop);
-	return crop_enabled(&crop) || scale_filter_enabled(item) ||
-	       (item_is_scene(item) && !obs_sceneitem_is_group(item));
+	return item_is_scene(item) && !obs_sceneitem_is_group(item);
 }
 
-void pos_add_center(struct vec2 *pos, uint32_t alignment, uint32_t cx,
-		    uint32_t cy)
+static void snapshot_capture_side(struct move_snapshot_side *side, size_t i,
+				  obs_sceneitem_t *item)
 {
-	if (alignment & OBS_ALIGN_LEFT) {
-		pos->x -= cx >> 1;
-	} else if (alignment & OBS_ALIGN_RIGHT) {
-		pos->x += cx >> 1;
-	}
-	if (alignment & OBS_ALIGN_TOP) {
-		pos->y -= cy >> 1;
-	} else if (alignment & OBS_ALIGN_BOTTOM) {
-		pos->y += cy >> 1;
+	struct vec2 v;
+	struct obs_sceneitem_crop crop = {0};
+	if (!item) {
+		side->pos_x[i] = side->pos_y[i] = 0.0f;
+		side->scale_x[i] = side->scale_y[i] = 0.0f;
+		side->bounds_x[i] = side->bounds_y[i] = 0.0f;
+		side->rot[i] = 0.0f;
+		side->crop_left[i] = side->crop_top[i] = 0;
+		side->crop_right[i] = side->crop_bottom[i] = 0;
+		side->alignment[i] = side->bounds_alignment[i] = 0;
+		side->bounds_type[i] = OBS_BOUNDS_NONE;
+		side->scale_filter[i] = OBS_SCALE_DISABLE;
+		side->flags[i] = 0;
+		return;
 	}
+	obs_sceneitem_get_pos(item, &v);
+	side->pos_x[i] = v.x;
+	side->pos_y[i] = v.y;
+	obs_sceneitem_get_scale(item, &v);
+	side->scale_x[i] = v.x;
+	side->scale_y[i] = v.y;
+	obs_sceneitem_get_bounds(item, &v);
+	side->bounds_x[i] = v.x;
+	side->bounds_y[i] = v.y;
+	side->rot[i] = obs_sceneitem_get_rot(item);
+	obs_sceneitem_get_crop(item, &crop);
+	side->crop_left[i] = crop.left;
+	side->crop_top[i] = crop.top;
+	side->crop_right[i] = crop.right;
+	side->crop_bottom[i] = crop.bottom;
+	side->alignment[i] = obs_sceneitem_get_alignment(item);
+	side->bounds_alignment[i] = obs_sceneitem_get_bounds_alignment(item);
+	side->bounds_type[i] = obs_sceneitem_get_bounds_type(item);
+	side->scale_filter[i] = obs_sceneitem_get_scale_filter(item);
+	side->flags[i] = 0;
+	const bool nested_scene = item_is_nested_scene(item);
+	if (nested_scene)
+		side->flags[i] |= SNAPSHOT_NESTED_SCENE;
+	if (crop_enabled(&crop) || scale_filter_enabled(item) || nested_scene)
+		side->flags[i] |= SNAPSHOT_TEXTURE;
 }
 
-void pos_subtract_center(struct vec2 *pos, uint32_t alignment, uint32_t cx,
-			 uint32_t cy)
+static void *snapshot_field(float **data, size_t num)
 {
-	if (alignment & OBS_ALIGN_LEFT) {
-		pos->x += cx >> 1;
-	} else if (alignment & OBS_ALIGN_RIGHT) {
-		pos->x -= cx >> 1;
-	}
-	if (alignment & OBS_ALIGN_TOP) {
-		pos->y += cy >> 1;
-	} else if (alignment & OBS_ALIGN_BOTTOM) {
-		pos->y -= cy >> 1;
-	}
+	void *field = *data;
+	*data += num;
+	return field;
 }
 
-void calc_edge_position(struct vec2 *pos, long long position,
-			uint32_t canvas_width, uint32_t canvas_height,
-			uint32_t alignment, uint32_t cx, uint32_t cy, bool zoom)
+static void move_snapshot_resize(struct move_snapshot *snapshot, size_t num)
 {
-	uint32_t cx2 = cx >> 1;
-	uint32_t cy2 = cy >> 1;
-	if (zoom) {
-		cx2 = 0;
-		cy2 = 0;
-	}
-
-	if (position - POS_EDGE == 0) {
-		if (alignment & OBS_ALIGN_LEFT) {
-			pos->x += cx >> 1;
-		} else if (alignment & OBS_ALIGN_RIGHT) {
-			pos->x -= cx >> 1;
-		}
-		if (alignment & OBS_ALIGN_TOP) {
-			pos->y += cy >> 1;
-		} else if (alignment & OBS_ALIGN_BOTTOM) {
-			pos->y -= cy >> 1;
-		}
-		// pos is center of object
-		float diff_x = pos->x - (canvas_width >> 1);
-		float diff_y = pos->y - (canvas_height >> 1);
-		float factor_x = fabsf(diff_x) / (canvas_width >> 1);
-		float factor_y = fabsf(diff_y) / (canvas_height >> 1);
-
-		if (diff_x == 0.0f && diff_y == 0.0f) {
-			diff_y = 1.0f;
-		}
-		if (factor_x > factor_y) {
-			if (diff_x < 0.0f) {
-				//left edge
-				const float move_x = -(pos->x + cx2);
-				const float move_y =
-					diff_y * (diff_x + move_x) / diff_x;
-				vec2_set(pos, -(float)cx2,
-					 (float)(canvas_height >> 1) + move_y);
-			} else {
-				//right edge
-				const float move_x =
-					(canvas_width - pos->x) + cx2;
-				const float move_y =
-					diff_y * (diff_x + move_x) / diff_x;
-				vec2_set(pos, (float)canvas_width + cx2,
-					 (float)(canvas_height >> 1) + move_y);
-			}
-		} else {
-			if (diff_y < 0.0f) {
-				//top edge
-				const float move_y = -(pos->y + cy2);
-				const float move_x =
-					diff_x * (diff_y + move_y) / diff_y;
-				vec2_set(pos,
-					 (float)(canvas_width >> 1) + move_x,
-					 -(float)cy2);
-			} else {
-				//bottom edge
-				const float move_y =
-					(canvas_height - pos->y) + cy2;
-				const float move_x =
-					diff_x * (diff_y + move_y) / diff_y;
-				vec2_set(pos,
-					 (float)(canvas_width >> 1) + move_x,
-					 (float)canvas_height + cy2);
-			}
-		}
-
-		if (alignment & OBS_ALIGN_LEFT) {
-			pos->x -= cx2;
-		} else if (alignment & OBS_ALIGN_RIGHT) {
-			pos->x += cx2;
-		}
-		if (alignment & OBS_ALIGN_TOP) {
-			pos->y -= cy2;
-		} else if (alignment & OBS_ALIGN_BOTTOM) {
-			pos->y += cy2;
-		}
-
-		return;
-	}
-	if (zoom) {
-		cx = 0;
-		cy = 0;
-	}
-	if (position & POS_EDGE)
-		vec2_set(pos, 0, 0);
-	if (position & POS_RIGHT) {
-		pos->x = (float)canvas_width;
-		if (alignment & OBS_ALIGN_RIGHT) {
-			pos->x += cx;
-		} else if (alignment & OBS_ALIGN_LEFT) {
-
-		} else {
-			pos->x += cx2;
-		}
-	} else if (position & POS_LEFT) {
-		pos->x = 0;
-		if (alignment & OBS_ALIGN_RIGHT) {
-
-		} else if (alignment & OBS_ALIGN_LEFT) {
-			pos->x -= cx;
-		} else {
-			pos->x -= cx2;
-		}
-	} else if (position & POS_EDGE) {
-		pos->x = (float)(canvas_width >> 1);
-		if (alignment & OBS_ALIGN_RIGHT) {
-			pos->x += cx2;
-		} else if (alignment & OBS_ALIGN_LEFT) {
-			pos->x -= cx2;
+	if (num > snapshot->capacity) {
+		bfree(snapshot->data);
+		// every field is 4 bytes wide and gets num slots per side
+		snapshot->data = bzalloc(num * SNAPSHOT_FIELDS *
+					 SNAPSHOT_SIDES * sizeof(float));
+		snapshot->capacity = num;
+		float *data = snapshot->data;
+		for (size_t s = 0; s < SNAPSHOT_SIDES; s++) {
+			struct move_snapshot_side *side = &snapshot->side[s];
+			side->pos_x = snapshot_field(&data, num);
+			side->pos_y = snapshot_field(&data, num);
+			side->scale_x = snapshot_field(&data, num);
+			side->scale_y = snapshot_field(&data, num);
+			side->bounds_x = snapshot_field(&data, num);
+			side->bounds_y = snapshot_field(&data, num);
+			side->rot = snapshot_field(&data, num);
+			side->crop_left = snapshot_field(&data, num);
+			side->crop_top = snapshot_field(&data, num);
+			side->crop_right = snapshot_field(&data, num);
+			side->crop_bottom = snapshot_field(&data, num);
+			side->alignment = snapshot_field(&data, num);
+			side->bounds_alignment = snapshot_field(&data, num);
+			side->bounds_type = snapshot_field(&data, num);
+			side->scale_filter = snapshot_field(&data, num);
+			side->flags = snapshot_field(&data, num);
 		}
 	}
+	snapshot->num = num;
+}
 
-	if (position & POS_BOTTOM) {
-		pos->y = (float)canvas_height;
-		if (alignment & OBS_ALIGN_TOP) {
-		} else if (alignment & OBS_ALIGN_BOTTOM) {
-			pos->y += cy;
-		} else {
-			pos->y += cy2;
-		}
-	} else if (position & POS_TOP) {
-		pos->y = 0;
-		if (alignment & OBS_ALIGN_BOTTOM) {
-		} else if (alignment & OBS_ALIGN_TOP) {
-			pos->y -= cy;
-		} else {
-			pos->y -= cy2;
-		}
-	} else if (position & POS_EDGE) {
-		pos->y = (float)(canvas_height >> 1);
-		if (alignment & OBS_ALIGN_TOP) {
-			pos->y -= cy2;
-		} else if (alignment & OBS_ALIGN_BOTTOM) {
-			pos->y += cy2;
+static void move_frame_resize(struct move_frame *frame, size_t num)
+{
+	if (num > frame->capacity) {
+		bfree(frame->data);
+		frame->data = bzalloc(num * FRAME_FIELDS * sizeof(float));
+		frame->capacity = num;
+		float *data = frame->data;
+		frame->t = snapshot_field(&data, num);
+		frame->ot = snapshot_field(&data, num);
+		frame->pos_x = snapshot_field(&data, num);
+		frame->pos_y = snapshot_field(&data, num);
+		frame->scale_x = snapshot_field(&data, num);
+		frame->scale_y = snapshot_field(&data, num);
+		frame->bounds_x = snapshot_field(&data, num);
+		frame->bounds_y = snapshot_field(&data, num);
+		frame->rot = snapshot_field(&data, num);
+		frame->crop_left = snapshot_field(&data, num);
+		frame->crop_top = snapshot_field(&data, num);
+		frame->crop_right = snapshot_field(&data, num);
+		frame->crop_bottom = snapshot_field(&data, num);
+		for (size_t s = 0; s < SNAPSHOT_SIDES; s++) {
+			frame->source_cx[s] = snapshot_field(&data, num);
+			frame->source_cy[s] = snapshot_field(&data, num);
 		}
 	}
+	da_resize(frame->ease, num);
+	da_resize(frame->layouts, num);
 }
 
-float bezier(float point[], float t, int order)
+static void move_snapshot_capture(struct move_plan *plan)
 {
-	const float p = 1.0f - t;
-	if (order < 1)
-		return point[0];
-	if (order == 1)
-		return p * point[0] + t * point[1];
-	return p * bezier(point, t, order - 1) +
-	       t * bezier(&point[1], t, order - 1);
+	struct move_snapshot *snapshot = &plan->snapshot;
+	move_snapshot_resize(snapshot, plan->items_a.num);
+	move_frame_resize(&plan->frame, plan->items_a.num);
+	for (size_t i = 0; i < plan->items_a.num; i++) {
+		struct move_item *item = plan->items_a.array[i];
+		item->snapshot_index = i;
+		snapshot_capture_side(&snapshot->side[SNAPSHOT_A], i,
+				      item->item_a);
+		snapshot_capture_side(&snapshot->side[SNAPSHOT_B], i,
+				      item->item_b);
+	}
 }
 
-void vec2_bezier(struct vec2 *dst, struct vec2 *begin, struct vec2 *control,
-		 struct vec2 *end, const float t)
+// without crop or a scaling filter at work this frame the offscreen pass
+// would be an identity copy, nested scenes still need it for blending
+static bool item_render_needed(struct move_snapshot *snapshot,
+			       struct move_item *item,
+			       struct move_snapshot_side *side,
+			       const struct obs_sceneitem_crop *crop,
+			       const struct vec2 *scale)
 {
-	float x[3] = {begin->x, control->x, end->x};
-	float y[3] = {begin->y, control->y, end->y};
-	dst->x = bezier(x, t, 2);
-	dst->y = bezier(y, t, 2);
+	const size_t i = item->snapshot_index;
+	if ((snapshot->side[SNAPSHOT_A].flags[i] & SNAPSHOT_NESTED_SCENE) ||
+	    (snapshot->side[SNAPSHOT_B].flags[i] & SNAPSHOT_NESTED_SCENE))
+		return true;
+	if (crop_enabled(crop))
+		return true;
+	if (side->scale_filter[i] == OBS_SCALE_DISABLE)
+		return false;
+	return !close_float(scale->x, 1.0f, EPSILON) ||
+	       !close_float(scale->y, 1.0f, EPSILON);
 }
 
 static obs_source_t *obs_frontend_get_transition(const char *name)
@@ -564,131 +966,76 @@ static obs_source_t *obs_frontend_get_transition(const char *name)
 		}
 	}
 	obs_frontend_source_list_free(&transitions);
-	return NULL;
-}
-
-float get_eased(float f, long long easing, long long easing_function)
-{
-	float t = f;
-	if (EASE_NONE == easing) {
-	} else if (EASE_IN == easing) {
-		switch (easing_function) {
-		case EASING_QUADRATIC:
-			t = QuadraticEaseIn(f);
-			break;
-		case EASING_CUBIC:
-			t = CubicEaseIn(f);
-			break;
-		case EASING_QUARTIC:
-			t = QuarticEaseIn(f);
-			break;
-		case EASING_QUINTIC:
-			t = QuinticEaseIn(f);
-			break;
-		case EASING_SINE:
-			t = SineEaseIn(f);
-			break;
-		case EASING_CIRCULAR:
-			t = CircularEaseIn(f);
-			break;
-		case EASING_EXPONENTIAL:
-			t = ExponentialEaseIn(f);
-			break;
-		case EASING_ELASTIC:
-			t = ElasticEaseIn(f);
-			break;
-		case EASING_BOUNCE:
-			t = BounceEaseIn(f);
-			break;
-		case EASING_BACK:
-			t = BackEaseIn(f);
-			break;
-		default:;
-		}
-	} else if (EASE_OUT == easing) {
-		switch (easing_function) {
-		case EASING_QUADRATIC:
-			t = QuadraticEaseOut(f);
-			break;
-		case EASING_CUBIC:
-			t = CubicEaseOut(f);
-			break;
-		case EASING_QUARTIC:
-			t = QuarticEaseOut(f);
-			break;
-		case EASING_QUINTIC:
-			t = QuinticEaseOut(f);
-			break;
-		case EASING_SINE:
-			t = SineEaseOut(f);
-			break;
-		case EASING_CIRCULAR:
-			t = CircularEaseOut(f);
-			break;
-		case EASING_EXPONENTIAL:
-			t = ExponentialEaseOut(f);
-			break;
-		case EASING_ELASTIC:
-			t = ElasticEaseOut(f);
-			break;
-		case EASING_BOUNCE:
-			t = BounceEaseOut(f);
-			break;
-		case EASING_BACK:
-			t = BackEaseOut(f);
-			break;
-		default:;
-		}
-	} else if (EASE_IN_OUT == easing) {
-		switch (easing_function) {
-		case EASING_QUADRATIC:
-			t = QuadraticEaseInOut(f);
-			break;
-		case EASING_CUBIC:
-			t = CubicEaseInOut(f);
-			break;
-		case EASING_QUARTIC:
-			t = QuarticEaseInOut(f);
-			break;
-		case EASING_QUINTIC:
-			t = QuinticEaseInOut(f);
-			break;
-		case EASING_SINE:
-			t = SineEaseInOut(f);
-			break;
-		case EASING_CIRCULAR:
-			t = CircularEaseInOut(f);
-			break;
-		case EASING_EXPONENTIAL:
-			t = ExponentialEaseInOut(f);
-			break;
-		case EASING_ELASTIC:
-			t = ElasticEaseInOut(f);
-			break;
-		case EASING_BOUNCE:
-			t = BounceEaseInOut(f);
-			break;
-		case EASING_BACK:
-			t = BackEaseInOut(f);
-			break;
-		default:;
-		}
-	}
-	return t;
+	return NULL;
 }
 
-obs_source_t *get_transition(const char *transition_name, void *pool_data,
-			     size_t *index, bool cache)
+static const AHEasingFunction easing_functions[3][EASING_BACK + 1] = {
+	{
+		NULL,
+		QuadraticEaseIn,
+		CubicEaseIn,
+		QuarticEaseIn,
+		QuinticEaseIn,
+		SineEaseIn,
+		CircularEaseIn,
+		ExponentialEaseIn,
+		ElasticEaseIn,
+		BounceEaseIn,
+		BackEaseIn,
+	},
+	{
+		NULL,
+		QuadraticEaseOut,
+		CubicEaseOut,
+		QuarticEaseOut,
+		QuinticEaseOut,
+		SineEaseOut,
+		CircularEaseOut,
+		ExponentialEaseOut,
+		ElasticEaseOut,
+		BounceEaseOut,
+		BackEaseOut,
+	},
+	{
+		NULL,
+		QuadraticEaseInOut,
+		CubicEaseInOut,
+		QuarticEaseInOut,
+		QuinticEaseInOut,
+		SineEaseInOut,
+		CircularEaseInOut,
+		ExponentialEaseInOut,
+		ElasticEaseInOut,
+		BounceEaseInOut,
+		BackEaseInOut,
+	}};
+
+AHEasingFunction get_easing_function(long long easing,
+				     long long easing_function)
 {
+	if (easing < EASE_IN || easing > EASE_IN_OUT ||
+	    easing_function < EASING_QUADRATIC ||
+	    easing_function > EASING_BACK)
+		return NULL;
+	return easing_functions[easing - EASE_IN][easing_function];
+}
 
+static obs_source_t *get_transition(struct move_info *move,
+				    const char *transition_name,
+				    void *pool_data, size_t *index)
+{
 	DARRAY(obs_source_t *) *transition_pool = pool_data;
+	const bool cache = move->cache_transitions;
 	const size_t i = *index;
 	if (cache && transition_pool->num && *index < transition_pool->num) {
 		obs_source_t *transition = transition_pool->array[i];
 		obs_source_addref(transition);
 		*index = i + 1;
+		os_atomic_inc_long(&move->transition_pool_hits);
 		return transition;
 	}
+	if (cache)
+		os_atomic_inc_long(&move->transition_pool_misses);
 	obs_source_t *frontend_transition =
 		obs_frontend_get_transition(transition_name);
 	if (!frontend_transition)
@@ -705,31 +1052,32 @@ obs_source_t *get_transition(const char *transition_name, void *pool_data,
 	return transition;
 }
 
-bool render2_item(struct move_info *move, struct move_item *item)
+static void move_frame_source_size(struct move_frame *frame, size_t s,
+				   size_t i, obs_sceneitem_t *item)
 {
-	obs_sceneitem_t *scene_item = NULL;
-	if (item->item_a && item->item_b) {
-		if (move->t <= 0.5) {
-			scene_item = item->item_a;
-		} else {
-			scene_item = item->item_b;
-		}
-	} else if (item->item_a) {
-		scene_item = item->item_a;
-	} else if (item->item_b) {
-		scene_item = item->item_b;
-	}
+	obs_source_t *source = item ? obs_sceneitem_get_source(item) : NULL;
+	frame->source_cx[s][i] = source ? obs_source_get_width(source) : 0;
+	frame->source_cy[s][i] = source ? obs_source_get_height(source) : 0;
+}
+
+static void move_item_prepare(struct move_info *move, struct move_frame *frame,
+			      struct move_item *item)
+{
+	obs_sceneitem_t *scene_item = move_item_scene_item(move->t, item);
+	const size_t i = item->snapshot_index;
+	const size_t s = scene_item == item->item_a ? SNAPSHOT_A : SNAPSHOT_B;
 	obs_source_t *source = obs_sceneitem_get_source(scene_item);
-	uint32_t width = obs_source_get_width(source);
-	uint32_t height = obs_source_get_height(source);
+	move_frame_source_size(frame, SNAPSHOT_A, i, item->item_a);
+	move_frame_source_size(frame, SNAPSHOT_B, i, item->item_b);
+	uint32_t width = frame->source_cx[s][i];
+	uint32_t height = frame->source_cy[s][i];
 	bool move_out = item->item_a == scene_item;
 	if (item->move_scene) {
 		if (item->transition_name && !item->transition) {
 			item->transition = get_transition(
-				item->transition_name,
+				move, item->transition_name,
 				&move->transition_pool_move,
-				&move->transition_pool_move_index,
-				move->cache_transitions);
+				&move->transition_pool_move_index);
 			if (item->transition) {
 				obs_transition_set_size(item->transition, width,
 							height);
@@ -753,10 +1101,9 @@ bool render2_item(struct move_info *move, struct move_item *item)
 	} else if (item->item_a && item->item_b) {
 		if (item->transition_name && !item->transition) {
 			item->transition = get_transition(
-				item->transition_name,
+				move, item->transition_name,
 				&move->transition_pool_move,
-				&move->transition_pool_move_index,
-				move->cache_transitions);
+				&move->transition_pool_move_index);
 			if (item->transition) {
 				obs_transition_set_size(item->transition, width,
 							height);
@@ -779,9 +1126,9 @@ bool render2_item(struct move_info *move, struct move_item *item)
 		}
 	} else if (move_out && item->transition_name && !item->transition) {
 		item->transition = get_transition(
-			item->transition_name, &move->transition_pool_out,
-			&move->transition_pool_out_index,
-			move->cache_transitions);
+			move, item->transition_name,
+			&move->transition_pool_out,
+			&move->transition_pool_out_index);
 		if (item->transition) {
 			obs_transition_set_size(item->transition, width,
 						height);
@@ -799,9 +1146,9 @@ bool render2_item(struct move_info *move, struct move_item *item)
 		}
 	} else if (!move_out && item->transition_name && !item->transition) {
 		item->transition = get_transition(
-			item->transition_name, &move->transition_pool_in,
-			&move->transition_pool_in_index,
-			move->cache_transitions);
+			move, item->transition_name,
+			&move->transition_pool_in,
+			&move->transition_pool_in_index);
 
 		if (item->transition) {
 			obs_transition_set_size(item->transition, width,
@@ -820,7 +1167,9 @@ bool render2_item(struct move_info *move, struct move_item *item)
 		}
 	}
 
+	// easing is applied afterwards for the whole frame in move_frame_ease
 	float t = 0.0f;
+	AHEasingFunction ease = NULL;
 	if (item->start_percentage > 0 || item->end_percentage < 100) {
 		if (item->start_percentage > item->end_percentage) {
 			float avg_switch_point =
@@ -839,333 +1188,45 @@ bool render2_item(struct move_info *move, struct move_item *item)
 				item->end_percentage - item->start_percentage;
 			t = move->t - (float)item->start_percentage / 100.0f;
 			t = t / (float)duration_percentage * 100.0f;
-			t = get_eased(t, item->easing, item->easing_function);
-		}
-	} else {
-		t = get_eased(move->t, item->easing, item->easing_function);
-	}
-	float ot = t;
-	if (t > 1.0f)
-		ot = 1.0f;
-	else if (t < 0.0f)
-		ot = 0.0f;
-
-	if (item->item_a && item->item_b && item->transition &&
-	    !move->start_init) {
-		uint32_t width_a = obs_source_get_width(
-			obs_sceneitem_get_source(item->item_a));
-		uint32_t width_b = obs_source_get_width(
-			obs_sceneitem_get_source(item->item_b));
-		uint32_t height_a = obs_source_get_height(
-			obs_sceneitem_get_source(item->item_a));
-		uint32_t height_b = obs_source_get_height(
-			obs_sceneitem_get_source(item->item_b));
-		width = (uint32_t)((1.0f - t) * width_a + t * width_b);
-		height = (uint32_t)((1.0f - t) * height_a + t * height_b);
-		obs_transition_set_size(item->transition, width, height);
-	}
-
-	uint32_t original_width = width;
-	uint32_t original_height = height;
-	struct obs_sceneitem_crop crop;
-	if (item->move_scene) {
-		obs_sceneitem_get_crop(scene_item, &crop);
-		if (item->item_a) {
-			crop.left =
-				(int)((float)(1.0f - ot) * (float)crop.left);
-			crop.top = (int)((float)(1.0f - ot) * (float)crop.top);
-			crop.right =
-				(int)((float)(1.0f - ot) * (float)crop.right);
-			crop.bottom =
-				(int)((float)(1.0f - ot) * (float)crop.bottom);
-		} else if (item->item_b) {
-			crop.left = (int)((float)ot * (float)crop.left);
-			crop.top = (int)((float)ot * (float)crop.top);
-			crop.right = (int)((float)ot * (float)crop.right);
-			crop.bottom = (int)((float)ot * (float)crop.bottom);
-		}
-	} else if (item->item_a && item->item_b) {
-		struct obs_sceneitem_crop crop_a;
-		obs_sceneitem_get_crop(item->item_a, &crop_a);
-		struct obs_sceneitem_crop crop_b;
-		obs_sceneitem_get_crop(item->item_b, &crop_b);
-		crop.left = (int)((float)(1.0f - ot) * (float)crop_a.left +
-				  ot * (float)crop_b.left);
-		crop.top = (int)((float)(1.0f - ot) * (float)crop_a.top +
-				 ot * (float)crop_b.top);
-		crop.right = (int)((float)(1.0f - ot) * (float)crop_a.right +
-				   ot * (float)crop_b.right);
-		crop.bottom = (int)((float)(1.0f - ot) * (float)crop_a.bottom +
-				    ot * (float)crop_b.bottom);
-	} else {
-		obs_sceneitem_get_crop(scene_item, &crop);
-	}
-	uint32_t crop_cx = crop.left + crop.right;
-	uint32_t cx = (crop_cx > width) ? 2 : (width - crop_cx);
-	uint32_t crop_cy = crop.top + crop.bottom;
-	uint32_t cy = (crop_cy > height) ? 2 : (height - crop_cy);
-	struct vec2 scale;
-	struct vec2 original_scale;
-	obs_sceneitem_get_scale(scene_item, &original_scale);
-	if (item->item_a && item->item_b) {
-		struct vec2 scale_a;
-		obs_sceneitem_get_scale(item->item_a, &scale_a);
-		struct vec2 scale_b;
-		obs_sceneitem_get_scale(item->item_b, &scale_b);
-		vec2_set(&scale, (1.0f - t) * scale_a.x + t * scale_b.x,
-			 (1.0f - t) * scale_a.y + t * scale_b.y);
-	} else {
-		if (obs_sceneitem_get_bounds_type(scene_item) !=
-		    OBS_BOUNDS_NONE) {
-			obs_sceneitem_get_scale(scene_item, &scale);
-		} else {
-			obs_sceneitem_get_scale(scene_item, &scale);
-			if (item->move_scene) {
-				if (item->item_a) {
-					vec2_set(&scale,
-						 (1.0f - t) * scale.x + t,
-						 (1.0f - t) * scale.y + t);
-				} else if (item->item_b) {
-					vec2_set(&scale,
-						 (1.0f - t) + t * scale.x,
-						 (1.0f - t) + t * scale.y);
-				}
-			} else if (!move_out && item->zoom) {
-				vec2_set(&scale, t * scale.x, t * scale.y);
-			} else if (move_out && item->zoom) {
-				vec2_set(&scale, (1.0f - t) * scale.x,
-					 (1.0f - t) * scale.y);
-			}
-		}
-	}
-	width = cx;
-	height = cy;
-	uint32_t original_cx = cx;
-	uint32_t original_cy = cy;
-
-	struct vec2 base_origin;
-	struct vec2 origin;
-	struct vec2 origin2;
-	vec2_zero(&base_origin);
-	vec2_zero(&origin);
-	vec2_zero(&origin2);
-
-	uint32_t canvas_width = obs_source_get_width(move->source);
-	uint32_t canvas_height = obs_source_get_height(move->source);
-
-	if (obs_sceneitem_get_bounds_type(scene_item) != OBS_BOUNDS_NONE) {
-		struct vec2 bounds;
-		if (item->move_scene) {
-			obs_sceneitem_get_bounds(scene_item, &bounds);
-			if (item->item_a) {
-				vec2_set(&bounds,
-					 (1.0f - t) * bounds.x +
-						 t * canvas_width,
-					 (1.0f - t) * bounds.y +
-						 t * canvas_height);
-			} else if (item->item_b) {
-				vec2_set(&bounds,
-					 (1.0f - t) * canvas_width +
-						 t * bounds.x,
-					 (1.0f - t) * canvas_height +
-						 t * bounds.y);
-			}
-		} else if (item->item_a && item->item_b) {
-			struct vec2 bounds_a;
-			obs_sceneitem_get_bounds(item->item_a, &bounds_a);
-			struct vec2 bounds_b;
-			obs_sceneitem_get_bounds(item->item_b, &bounds_b);
-			vec2_set(&bounds,
-				 (1.0f - t) * bounds_a.x + t * bounds_b.x,
-				 (1.0f - t) * bounds_a.y + t * bounds_b.y);
-		} else {
-			obs_sceneitem_get_bounds(scene_item, &bounds);
-			if (!move_out && item->zoom) {
-				vec2_set(&bounds, t * bounds.x, t * bounds.y);
-			} else if (move_out && item->zoom) {
-				vec2_set(&bounds, (1.0f - t) * bounds.x,
-					 (1.0f - t) * bounds.y);
-			}
-		}
-		if (item->item_a && item->item_b &&
-		    (obs_sceneitem_get_bounds_alignment(item->item_a) !=
-			     obs_sceneitem_get_bounds_alignment(item->item_b) ||
-		     obs_sceneitem_get_bounds_type(item->item_a) !=
-			     obs_sceneitem_get_bounds_type(item->item_b))) {
-			calculate_move_bounds_data(item->item_a, item->item_b,
-						   t, &origin, &scale, &cx, &cy,
-						   &bounds);
-
-		} else {
-			calculate_bounds_data(scene_item, &origin, &scale, &cx,
-					      &cy, &bounds);
-		}
-		struct vec2 original_bounds;
-		obs_sceneitem_get_bounds(scene_item, &original_bounds);
-		calculate_bounds_data(scene_item, &origin2, &original_scale,
-				      &original_cx, &original_cy,
-				      &original_bounds);
-	} else {
-		original_cx = (uint32_t)((float)cx * original_scale.x);
-		original_cy = (uint32_t)((float)cy * original_scale.y);
-		cx = (uint32_t)((float)cx * scale.x);
-		cy = (uint32_t)((float)cy * scale.y);
-	}
-	if (item->item_a && item->item_b &&
-	    obs_sceneitem_get_alignment(item->item_a) !=
-		    obs_sceneitem_get_alignment(item->item_b)) {
-		add_move_alignment(&origin,
-				   obs_sceneitem_get_alignment(item->item_a),
-				   obs_sceneitem_get_alignment(item->item_b), t,
-				   (int)cx, (int)cy);
-	} else {
-		add_alignment(&origin, obs_sceneitem_get_alignment(scene_item),
-			      (int)cx, (int)cy);
-	}
-
-	struct matrix4 draw_transform;
-	matrix4_identity(&draw_transform);
-	matrix4_scale3f(&draw_transform, &draw_transform, scale.x, scale.y,
-			1.0f);
-	matrix4_translate3f(&draw_transform, &draw_transform, -origin.x,
-			    -origin.y, 0.0f);
-	float rot;
-	if (item->move_scene) {
-		rot = obs_sceneitem_get_rot(scene_item);
-		if (item->item_a) {
-			rot *= (1.0f - t);
-		} else if (item->item_b) {
-			rot *= t;
-		}
-	} else if (item->item_a && item->item_b) {
-		float rot_a = obs_sceneitem_get_rot(item->item_a);
-		float rot_b = obs_sceneitem_get_rot(item->item_b);
-		rot = (1.0f - t) * rot_a + t * rot_b;
-	} else {
-		rot = obs_sceneitem_get_rot(scene_item);
-	}
-	matrix4_rotate_aa4f(&draw_transform, &draw_transform, 0.0f, 0.0f, 1.0f,
-			    RAD(rot));
-
-	struct vec2 pos_a;
-	if (item->item_a) {
-		obs_sceneitem_get_pos(item->item_a, &pos_a);
-	} else if (item->move_scene) {
-		uint32_t alignment = obs_sceneitem_get_alignment(scene_item);
-		vec2_set(&pos_a, 0, 0);
-		if (alignment & OBS_ALIGN_RIGHT) {
-			pos_a.x += canvas_width;
-		} else if (alignment & OBS_ALIGN_LEFT) {
-
-		} else {
-			pos_a.x += canvas_width >> 1;
-		}
-		if (alignment & OBS_ALIGN_BOTTOM) {
-			pos_a.y += canvas_height;
-		} else if (alignment & OBS_ALIGN_TOP) {
-
-		} else {
-			pos_a.x += canvas_height >> 1;
-		}
-	} else {
-		uint32_t alignment = obs_sceneitem_get_alignment(scene_item);
-		if (item->position & POS_CENTER) {
-			vec2_set(&pos_a, (float)(canvas_width >> 1),
-				 (float)(canvas_height >> 1));
-			if (!item->zoom)
-				pos_add_center(&pos_a, alignment, cx, cy);
-		} else if (item->position & POS_EDGE ||
-			   item->position & POS_SWIPE) {
-			obs_sceneitem_get_pos(item->item_b, &pos_a);
-			calc_edge_position(&pos_a, item->position, canvas_width,
-					   canvas_height, alignment,
-					   original_cx, original_cy,
-					   item->zoom);
-
-		} else {
-			obs_sceneitem_get_pos(item->item_b, &pos_a);
-			if (item->zoom)
-				pos_subtract_center(&pos_a, alignment,
-						    original_cx, original_cy);
-		}
-	}
-	struct vec2 pos_b;
-	if (item->item_b) {
-		obs_sceneitem_get_pos(item->item_b, &pos_b);
-	} else if (item->move_scene) {
-		uint32_t alignment = obs_sceneitem_get_alignment(scene_item);
-		vec2_set(&pos_b, 0, 0);
-		if (alignment & OBS_ALIGN_RIGHT) {
-			pos_b.x += canvas_width;
-		} else if (alignment & OBS_ALIGN_LEFT) {
-
-		} else {
-			pos_b.x += canvas_width >> 1;
-		}
-		if (alignment & OBS_ALIGN_BOTTOM) {
-			pos_b.y += canvas_height;
-		} else if (alignment & OBS_ALIGN_TOP) {
-
-		} else {
-			pos_b.x += canvas_height >> 1;
-		}
-	} else {
-		uint32_t alignment = obs_sceneitem_get_alignment(scene_item);
-		if (item->position & POS_CENTER) {
-			vec2_set(&pos_b, (float)(canvas_width >> 1),
-				 (float)(canvas_height >> 1));
-			if (!item->zoom)
-				pos_add_center(&pos_b, alignment, cx, cy);
-		} else if (item->position & POS_EDGE ||
-			   item->position & POS_SWIPE) {
-			obs_sceneitem_get_pos(item->item_a, &pos_b);
-			calc_edge_position(&pos_b, item->position, canvas_width,
-					   canvas_height, alignment,
-					   original_cx, original_cy,
-					   item->zoom);
-
-		} else {
-			obs_sceneitem_get_pos(item->item_a, &pos_b);
-			if (item->zoom)
-				pos_subtract_center(&pos_b, alignment,
-						    original_cx, original_cy);
-		}
-	}
-	struct vec2 pos;
-	if (item->curve != 0.0f) {
-		float diff_x = fabsf(pos_a.x - pos_b.x);
-		float diff_y = fabsf(pos_a.y - pos_b.y);
-		struct vec2 control_pos;
-		vec2_set(&control_pos, 0.5f * pos_a.x + 0.5f * pos_b.x,
-			 0.5f * pos_a.y + 0.5f * pos_b.y);
-		if (control_pos.x >= (canvas_width >> 1)) {
-			control_pos.x += diff_y * item->curve;
-		} else {
-			control_pos.x -= diff_y * item->curve;
+			ease = item->ease;
 		}
-		if (control_pos.y >= (canvas_height >> 1)) {
-			control_pos.y += diff_x * item->curve;
-		} else {
-			control_pos.y -= diff_x * item->curve;
-		}
-		vec2_bezier(&pos, &pos_a, &control_pos, &pos_b, t);
 	} else {
-		vec2_set(&pos, (1.0f - t) * pos_a.x + t * pos_b.x,
-			 (1.0f - t) * pos_a.y + t * pos_b.y);
+		t = move->t;
+		ease = item->ease;
 	}
+	frame->t[i] = t;
+	frame->ease.array[i] = ease;
+}
 
-	matrix4_translate3f(&draw_transform, &draw_transform, pos.x, pos.y,
-			    0.0f);
-
-	struct vec2 output_scale = scale;
-
-	if (item->item_render && !item_texture_enabled(item->item_a) &&
-	    !item_texture_enabled(item->item_b)) {
-		gs_texrender_destroy(item->item_render);
+bool render2_item(struct move_info *move, struct move_snapshot *snapshot,
+		  struct move_frame *frame, struct move_item *item)
+{
+	obs_sceneitem_t *scene_item = move_item_scene_item(move->t, item);
+	const size_t i = item->snapshot_index;
+	struct move_snapshot_side *side_a = &snapshot->side[SNAPSHOT_A];
+	struct move_snapshot_side *side_b = &snapshot->side[SNAPSHOT_B];
+	struct move_snapshot_side *side =
+		scene_item == item->item_a ? side_a : side_b;
+	obs_source_t *source = obs_sceneitem_get_source(scene_item);
+	struct move_item_layout *layout = &frame->layouts.array[i];
+	const float ot = frame->ot[i];
+	const uint32_t width = layout->width;
+	const uint32_t height = layout->height;
+	const uint32_t original_width = layout->original_width;
+	const uint32_t original_height = layout->original_height;
+	const struct obs_sceneitem_crop crop = layout->crop;
+	const struct vec2 output_scale = layout->output_scale;
+	uint32_t cx;
+	uint32_t cy;
+
+	const bool texture_enabled =
+		(side_a->flags[i] & SNAPSHOT_TEXTURE) ||
+		(side_b->flags[i] & SNAPSHOT_TEXTURE);
+	if (item->item_render && !texture_enabled) {
+		texrender_pool_release(item->item_render);
 		item->item_render = NULL;
-	} else if (!item->item_render && (item_texture_enabled(item->item_a) ||
-					  item_texture_enabled(item->item_b))) {
-		item->item_render = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	} else if (!item->item_render && texture_enabled) {
+		item->item_render = texrender_pool_acquire(width, height);
 	} else if (item->item_render) {
 		gs_texrender_reset(item->item_render);
 	}
@@ -1176,9 +1237,13 @@ bool render2_item(struct move_info *move, struct move_item *item)
 			gs_samplerstate_create(&point_sampler_info);
 	}
 
-	if (item->item_render) {
+	const bool use_render =
+		item->item_render &&
+		item_render_needed(snapshot, item, side, &crop, &output_scale);
+	if (use_render) {
 		if (width && height &&
 		    gs_texrender_begin(item->item_render, width, height)) {
+			move->frame_offscreen_passes++;
 			float cx_scale = (float)original_width / (float)width;
 			float cy_scale = (float)original_height / (float)height;
 			struct vec4 clear_color;
@@ -1210,8 +1275,8 @@ bool render2_item(struct move_info *move, struct move_item *item)
 	}
 
 	gs_matrix_push();
-	gs_matrix_mul(&draw_transform);
-	if (item->item_render) {
+	gs_matrix_mul(&layout->draw_transform);
+	if (use_render) {
 		//render_item_texture(item);
 		gs_texture_t *tex = gs_texrender_get_texture(item->item_render);
 		if (!tex) {
@@ -1221,8 +1286,7 @@ bool render2_item(struct move_info *move, struct move_item *item)
 
 		gs_effect_t *effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
 
-		enum obs_scale_type type =
-			obs_sceneitem_get_scale_filter(scene_item);
+		enum obs_scale_type type = side->scale_filter[i];
 		cx = gs_texture_get_width(tex);
 		cy = gs_texture_get_height(tex);
 		const char *tech = "Draw";
@@ -1300,6 +1364,19 @@ bool render2_item(struct move_info *move, struct move_item *item)
 	return true;
 }
 
+static void move_frame_update(struct move_info *move, struct move_plan *plan)
+{
+	struct move_frame *frame = &plan->frame;
+	for (size_t i = 0; i < plan->items_a.num; i++)
+		move_item_prepare(move, frame, plan->items_a.array[i]);
+	frame->move_t = move->t;
+	frame->start_init = move->start_init;
+	frame->canvas_width = obs_source_get_width(move->source);
+	frame->canvas_height = obs_source_get_height(move->source);
+	move_frame_layout(frame, &plan->snapshot, plan->items_a.array,
+			  plan->items_a.num);
+}
+
 bool same_transform_type(struct obs_transform_info *info_a,
 			 struct obs_transform_info *info_b)
 {
@@ -1311,183 +1388,221 @@ bool same_transform_type(struct obs_transform_info *info_a,
 	       info_a->bounds_alignment == info_b->bounds_alignment;
 }
 
-bool is_number_match(const char c)
+bool is_number_match(const char c);
+
+struct match_item_data {
+	struct move_plan *plan;
+	obs_sceneitem_t *scene_item;
+	bool part_match;
+	struct move_item *item;
+	size_t index;
+	uint64_t settings_hash;
+	bool settings_hashed;
+	bool has_settings;
+};
+
+static bool match_item_same_settings(struct match_item_data *match,
+				     size_t index, obs_source_t *check_source,
+				     obs_source_t *source)
 {
-	if (c >= '0' && c <= '9')
-		return true;
-	if (c == '(' || c == ')' || c == ' ' || c == '.' || c == ',')
-		return true;
-	return false;
+	if (!match->settings_hashed) {
+		match->has_settings =
+			match_settings_hash(source, &match->settings_hash);
+		match->settings_hashed = true;
+	}
+	uint64_t check_hash;
+	if (!match->has_settings ||
+	    !match_index_settings_hash(&match->plan->match_index, index,
+				       check_source, &check_hash) ||
+	    check_hash != match->settings_hash)
+		return false;
+
+	bool same = false;
+	obs_data_t *settings = obs_source_get_settings(source);
+	obs_data_t *check_settings = obs_source_get_settings(check_source);
+	if (settings && check_settings &&
+	    strcmp(obs_data_get_json(settings),
+		   obs_data_get_json(check_settings)) == 0) {
+		same = true;
+	}
+	obs_data_release(check_settings);
+	obs_data_release(settings);
+	return same;
 }
 
-struct move_item *match_item2(struct move_info *move,
-			      obs_sceneitem_t *scene_item, bool part_match,
-			      size_t *found_pos)
+static bool match_item_check(struct match_item_data *match,
+			     struct move_item *check_item, size_t index)
 {
-	struct move_item *item = NULL;
+	struct move_info *move = match->plan->move;
+	obs_sceneitem_t *scene_item = match->scene_item;
+	const bool part_match = match->part_match;
 	obs_source_t *source = obs_sceneitem_get_source(scene_item);
-	for (size_t i = 0; i < move->items_a.num; i++) {
-		struct move_item *check_item = move->items_a.array[i];
-		if (check_item->item_b)
-			continue;
-		if (obs_sceneitem_get_bounds_type(check_item->item_a) ==
-			    OBS_BOUNDS_NONE &&
-		    obs_sceneitem_get_bounds_type(scene_item) !=
-			    OBS_BOUNDS_NONE)
-			continue;
-		if (obs_sceneitem_get_bounds_type(check_item->item_a) !=
-			    OBS_BOUNDS_NONE &&
-		    obs_sceneitem_get_bounds_type(scene_item) ==
-			    OBS_BOUNDS_NONE)
-			continue;
+	if (check_item->item_b)
+		return false;
+	if (obs_sceneitem_get_bounds_type(check_item->item_a) ==
+		    OBS_BOUNDS_NONE &&
+	    obs_sceneitem_get_bounds_type(scene_item) != OBS_BOUNDS_NONE)
+		return false;
+	if (obs_sceneitem_get_bounds_type(check_item->item_a) !=
+		    OBS_BOUNDS_NONE &&
+	    obs_sceneitem_get_bounds_type(scene_item) == OBS_BOUNDS_NONE)
+		return false;
 
-		obs_source_t *check_source =
-			obs_sceneitem_get_source(check_item->item_a);
-		if (!check_source)
-			continue;
+	obs_source_t *check_source =
+		obs_sceneitem_get_source(check_item->item_a);
+	if (!check_source)
+		return false;
 
-		if (check_source == source) {
-			item = check_item;
-			*found_pos = i;
-			break;
-		}
-		const char *name_a = obs_source_get_name(check_source);
-		const char *name_b = obs_source_get_name(source);
-		if (name_a && name_b) {
-			if (strcmp(name_a, name_b) == 0) {
-				item = check_item;
-				*found_pos = i;
-				break;
+	if (check_source == source)
+		return true;
+	const char *name_a = obs_source_get_name(check_source);
+	const char *name_b = obs_source_get_name(source);
+	if (name_a && name_b) {
+		if (strcmp(name_a, name_b) == 0)
+			return true;
+		if (!part_match)
+			return false;
+		size_t len_a = strlen(name_a);
+		size_t len_b = strlen(name_b);
+		if (!len_a || !len_b)
+			return false;
+		if (len_a > len_b) {
+			if (move->last_word_match) {
+				char *last_space = strrchr(name_b, ' ');
+				if (last_space && last_space > name_b) {
+					len_b = last_space - name_b;
+				}
+			}
+			while (len_b > 0 && move->number_match &&
+			       is_number_match(name_b[len_b - 1]))
+				len_b--;
+			if (len_b > 0 && move->part_match) {
+				for (size_t pos = 0; pos <= len_a - len_b;
+				     pos++) {
+					if (memcmp(name_a + pos, name_b,
+						   len_b) == 0)
+						return true;
+				}
+			} else if (len_b > 0 &&
+				   memcmp(name_a, name_b, len_b) == 0) {
+				return true;
 			}
-			if (part_match) {
-				size_t len_a = strlen(name_a);
-				size_t len_b = strlen(name_b);
-				if (!len_a || !len_b)
-					continue;
-				if (len_a > len_b) {
-					if (move->last_word_match) {
-						char *last_space =
-							strrchr(name_b, ' ');
-						if (last_space &&
-						    last_space > name_b) {
-							len_b = last_space -
-								name_b;
-						}
-					}
-					while (len_b > 0 &&
-					       move->number_match &&
-					       is_number_match(
-						       name_b[len_b - 1]))
-						len_b--;
-					if (len_b > 0 && move->part_match) {
-						for (size_t pos = 0;
-						     pos <= len_a - len_b;
-						     pos++) {
-							if (memcmp(name_a + pos,
-								   name_b,
-								   len_b) ==
-							    0) {
-								item = check_item;
-								*found_pos = i;
-								break;
-							}
-						}
-						if (item)
-							break;
-					} else if (len_b > 0 &&
-						   memcmp(name_a, name_b,
-							  len_b) == 0) {
-						item = check_item;
-						*found_pos = i;
-						break;
-					}
-
-				} else {
-					if (move->last_word_match) {
-						char *last_space =
-							strrchr(name_a, ' ');
-						if (last_space &&
-						    last_space > name_a) {
-							len_a = last_space -
-								name_a;
-						}
-					}
-					while (len_a > 0 &&
-					       move->number_match &&
-					       is_number_match(
-						       name_a[len_a - 1]))
-						len_a--;
-					if (len_a > 0 && move->part_match) {
-						for (size_t pos = 0;
-						     pos <= len_b - len_a;
-						     pos++) {
-							if (memcmp(name_a,
-								   name_b + pos,
-								   len_a) ==
-							    0) {
-								item = check_item;
-								*found_pos = i;
-								break;
-							}
-						}
-						if (item)
-							break;
-					} else if (len_a > 0 &&
-						   memcmp(name_a, name_b,
-							  len_a) == 0) {
-						item = check_item;
-						*found_pos = i;
-						break;
-					}
+		} else {
+			if (move->last_word_match) {
+				char *last_space = strrchr(name_a, ' ');
+				if (last_space && last_space > name_a) {
+					len_a = last_space - name_a;
 				}
 			}
-		} else if (!part_match) {
-			if (obs_source_get_type(check_source) ==
-			    obs_source_get_type(source)) {
-				obs_data_t *settings =
-					obs_source_get_settings(source);
-				obs_data_t *check_settings =
-					obs_source_get_settings(check_source);
-				if (settings && check_settings &&
-				    strcmp(obs_data_get_json(settings),
-					   obs_data_get_json(check_settings)) ==
-					    0) {
-					item = check_item;
-					*found_pos = i;
-					obs_data_release(check_settings);
-					obs_data_release(settings);
-					break;
+			while (len_a > 0 && move->number_match &&
+			       is_number_match(name_a[len_a - 1]))
+				len_a--;
+			if (len_a > 0 && move->part_match) {
+				for (size_t pos = 0; pos <= len_b - len_a;
+				     pos++) {
+					if (memcmp(name_a, name_b + pos,
+						   len_a) == 0)
+						return true;
 				}
-				obs_data_release(check_settings);
-				obs_data_release(settings);
+			} else if (len_a > 0 &&
+				   memcmp(name_a, name_b, len_a) == 0) {
+				return true;
 			}
 		}
+	} else if (!part_match) {
+		if (obs_source_get_type(check_source) ==
+		    obs_source_get_type(source))
+			return match_item_same_settings(match, index,
+							check_source, source);
 	}
-	return item;
+	return false;
+}
+
+static void match_item_candidate(void *param, size_t index, void *data)
+{
+	struct match_item_data *match = param;
+	if (match->item && index >= match->index)
+		return;
+	if (!match_item_check(match, data, index))
+		return;
+	match->item = data;
+	match->index = index;
+}
+
+struct move_item *match_item2(struct move_plan *plan,
+			      obs_sceneitem_t *scene_item, bool part_match,
+			      size_t *found_pos)
+{
+	struct move_info *move = plan->move;
+	struct match_item_data match = {0};
+	match.plan = plan;
+	match.scene_item = scene_item;
+	match.part_match = part_match;
+	const char *name =
+		obs_source_get_name(obs_sceneitem_get_source(scene_item));
+	if (part_match) {
+		match_index_enum_parts(&plan->match_index, name,
+				       move->part_match, move->number_match,
+				       move->last_word_match,
+				       match_item_candidate, &match);
+	} else {
+		match_index_enum_exact(&plan->match_index, name,
+				       match_item_candidate, &match);
+	}
+	if (!match.item)
+		return NULL;
+	// the position in scene a, the index has the items in that order
+	*found_pos = match.index;
+	return match.item;
 }
 
-struct move_item *create_move_item()
+static struct move_item *create_move_item(struct move_plan *plan)
 {
-	struct move_item *item = bzalloc(sizeof(struct move_item));
+	const size_t block = plan->items_used / MOVE_ITEM_BLOCK;
+	if (block == plan->item_blocks.num) {
+		struct move_item *items =
+			bmalloc(MOVE_ITEM_BLOCK * sizeof(struct move_item));
+		da_push_back(plan->item_blocks, &items);
+	}
+	struct move_item *item =
+		&plan->item_blocks.array[block]
+			 [plan->items_used % MOVE_ITEM_BLOCK];
+	plan->items_used++;
+	memset(item, 0, sizeof(struct move_item));
 	item->end_percentage = 100;
 	return item;
 }
 
+static void move_plan_add_scene_item(struct move_plan *plan,
+				     obs_sceneitem_t *scene_item)
+{
+	struct move_plan_scene_item *known =
+		da_push_back_new(plan->scene_items);
+	obs_sceneitem_addref(scene_item);
+	known->item = scene_item;
+	known->id = obs_sceneitem_get_id(scene_item);
+	known->bounds = obs_sceneitem_get_bounds_type(scene_item) !=
+			OBS_BOUNDS_NONE;
+}
+
 bool add_item(obs_scene_t *scene, obs_sceneitem_t *scene_item, void *data)
 {
 	UNUSED_PARAMETER(scene);
 	if (!obs_sceneitem_visible(scene_item)) {
 		return true;
 	}
-	struct move_info *move = data;
-	struct move_item *item = create_move_item();
-	da_push_back(move->items_a, &item);
-	obs_sceneitem_addref(scene_item);
+	struct move_plan *plan = data;
+	struct move_item *item = create_move_item(plan);
+	da_push_back(plan->items_a, &item);
+	match_index_add(&plan->match_index,
+			obs_source_get_name(obs_sceneitem_get_source(scene_item)),
+			item);
+	move_plan_add_scene_item(plan, scene_item);
 	item->item_a = scene_item;
 	item->move_scene = obs_sceneitem_get_source(scene_item) ==
-			   move->scene_source_b;
+			   plan->scene_source_b;
 	if (item->move_scene)
-		move->matched_scene_b = true;
+		plan->matched_scene_b = true;
 	return true;
 }
 
@@ -1497,29 +1612,34 @@ bool match_item(obs_scene_t *scene, obs_sceneitem_t *scene_item, void *data)
 	if (!obs_sceneitem_visible(scene_item)) {
 		return true;
 	}
-	struct move_info *move = data;
+	struct move_plan *plan = data;
+	struct move_info *move = plan->move;
 	size_t old_pos;
-	struct move_item *item = match_item2(move, scene_item, false, &old_pos);
+	struct move_item *item = match_item2(plan, scene_item, false, &old_pos);
 	if (!item &&
 	    (move->part_match || move->number_match || move->last_word_match)) {
-		item = match_item2(move, scene_item, true, &old_pos);
+		item = match_item2(plan, scene_item, true, &old_pos);
 	}
 	if (item) {
-		move->matched_items++;
-		if (old_pos >= move->item_pos)
-			move->item_pos = old_pos + 1;
+		plan->matched_items++;
+		if (old_pos >= plan->item_pos)
+			plan->item_pos = old_pos + 1;
 	} else {
-		item = create_move_item();
-		da_insert(move->items_a, move->item_pos, &item);
-		move->item_pos++;
+		// placed after the last matched item of scene a when merging
+		item = create_move_item(plan);
+		struct move_order_insert *insert =
+			da_push_back_new(plan->inserts);
+		insert->item = item;
+		insert->pos = plan->item_pos;
 	}
-	obs_sceneitem_addref(scene_item);
+	item->order_index = plan->items_b.num;
+	move_plan_add_scene_item(plan, scene_item);
 	item->item_b = scene_item;
 	item->move_scene = obs_sceneitem_get_source(scene_item) ==
-			   move->scene_source_a;
+			   plan->scene_source_a;
 	if (item->move_scene)
-		move->matched_scene_a = true;
-	da_push_back(move->items_b, &item);
+		plan->matched_scene_a = true;
+	da_push_back(plan->items_b, &item);
 	return true;
 }
 void get_override_filter(obs_source_t *source, obs_source_t *filter,
@@ -1539,25 +1659,85 @@ void get_override_filter(obs_source_t *source, obs_source_t *filter,
 
 	if (obs_source_get_type(target) == OBS_SOURCE_TYPE_FILTER)
 		return;
-	obs_data_t *settings = obs_source_get_settings(filter);
-	if (!settings)
+	struct move_override *override = move_filter_get_override(filter);
+	if (!override)
 		return;
-	const char *sn = obs_data_get_string(settings, S_SOURCE);
-	if (sn && strlen(sn)) {
-		if (strcmp(obs_source_get_name(target), sn) == 0) {
+	if (override->source_name) {
+		if (strcmp(obs_source_get_name(target),
+			   override->source_name) == 0) {
 			*(obs_source_t **)param = filter;
 		}
 	}
-	obs_data_release(settings);
+	move_override_release(override);
+}
+
+static void scene_overrides_add(obs_source_t *parent, obs_source_t *filter,
+				void *param)
+{
+	UNUSED_PARAMETER(parent);
+	struct move_scene_overrides *overrides = param;
+	if (!obs_source_enabled(filter))
+		return;
+	if (strcmp(obs_source_get_unversioned_id(filter),
+		   "move_transition_override_filter") != 0)
+		return;
+	struct move_override *override = move_filter_get_override(filter);
+	if (!override)
+		return;
+	da_push_back(overrides->overrides, &override);
+	if (override->source_name)
+		match_index_add(&overrides->index, override->source_name,
+				override);
+}
+
+static void scene_overrides_build(struct move_scene_overrides *overrides,
+				  obs_source_t *scene_source)
+{
+	overrides->scene = obs_scene_from_source(scene_source);
+	if (overrides->scene)
+		obs_source_enum_filters(scene_source, scene_overrides_add,
+					overrides);
+}
+
+struct scene_override_find {
+	struct match_index *index;
+	const char *name;
+	struct move_override *override;
+};
+
+static void scene_override_found(void *param, size_t i, void *data)
+{
+	struct scene_override_find *find = param;
+	// hash matches, filters are indexed in order and the first one wins
+	if (!find->override &&
+	    strcmp(find->index->entries.array[i].name, find->name) == 0)
+		find->override = data;
 }
 
-obs_data_t *get_override_filter_settings(obs_sceneitem_t *item)
+struct move_override *get_override_filter_settings(struct move_plan *plan,
+						   obs_sceneitem_t *item)
 {
 	if (!item)
 		return NULL;
 	obs_source_t *filter = obs_sceneitem_get_source(item);
 	obs_scene_t *scene = obs_sceneitem_get_scene(item);
-	if (scene) {
+	struct move_scene_overrides *overrides = NULL;
+	if (scene && scene == plan->overrides_a.scene)
+		overrides = &plan->overrides_a;
+	else if (scene && scene == plan->overrides_b.scene)
+		overrides = &plan->overrides_b;
+	if (overrides) {
+		struct scene_override_find find = {&overrides->index,
+						   obs_source_get_name(filter),
+						   NULL};
+		if (find.name)
+			match_index_enum_exact(&overrides->index, find.name,
+					       scene_override_found, &find);
+		if (find.override) {
+			os_atomic_inc_long(&find.override->refs);
+			return find.override;
+		}
+	} else if (scene) {
 		obs_source_t *scene_source = obs_scene_get_source(scene);
 		obs_source_enum_filters(scene_source, get_override_filter,
 					&filter);
@@ -1568,409 +1748,451 @@ obs_data_t *get_override_filter_settings(obs_sceneitem_t *item)
 		return NULL;
 
 	if (filter && filter != source)
-		return obs_source_get_settings(filter);
+		return move_filter_get_override(filter);
 
 	filter = NULL;
 	obs_source_enum_filters(source, get_override_filter, &filter);
 	if (filter && filter != source)
-		return obs_source_get_settings(filter);
+		return move_filter_get_override(filter);
 	return NULL;
 }
 
+static bool move_items_named(struct move_plan *plan)
+{
+	for (size_t i = 0; i < plan->items_a.num; i++) {
+		struct move_item *item = plan->items_a.array[i];
+		if (item->item_a &&
+		    !obs_source_get_name(obs_sceneitem_get_source(item->item_a)))
+			return false;
+		if (item->item_b &&
+		    !obs_source_get_name(obs_sceneitem_get_source(item->item_b)))
+			return false;
+	}
+	return true;
+}
+
+// merges the inserts into the order in one pass, their positions only grow
+static void move_order_merge(struct move_plan *plan, struct darray *items)
+{
+	struct move_item **base = items->array;
+	const size_t num = items->num;
+	da_resize(plan->order, num + plan->inserts.num);
+	size_t n = 0;
+	size_t k = 0;
+	for (size_t i = 0; i <= num; i++) {
+		while (k < plan->inserts.num &&
+		       plan->inserts.array[k].pos == i)
+			plan->order.array[n++] = plan->inserts.array[k++].item;
+		if (i < num)
+			plan->order.array[n++] = base[i];
+	}
+	const struct darray merged = plan->order.da;
+	plan->order.da = *items;
+	*items = merged;
+	plan->inserts.num = 0;
+}
+
+static struct move_plan *move_plan_create(struct move_info *move,
+					  obs_source_t *scene_a,
+					  obs_source_t *scene_b)
+{
+	const uint64_t start = os_gettime_ns();
+	// bmem counts are global, so other threads make this approximate
+	const long allocs = bnum_allocs();
+	// called with plan_mutex held, which guards the spare plan
+	struct move_plan *plan = move->spare_plan;
+	move->spare_plan = NULL;
+	if (!plan) {
+		plan = bzalloc(sizeof(struct move_plan));
+		match_index_init(&plan->match_index);
+		match_index_init(&plan->overrides_a.index);
+		match_index_init(&plan->overrides_b.index);
+	}
+	plan->move = move;
+	plan->scene_source_a = scene_a;
+	plan->scene_source_b = scene_b;
+	plan->weak_source_a = obs_source_get_weak_source(scene_a);
+	plan->weak_source_b = obs_source_get_weak_source(scene_b);
+	plan->attached = true;
+	scene_signals_connect(plan, scene_a, true);
+	scene_signals_connect(plan, scene_b, true);
+	plan->generation = os_atomic_load_long(&move->generation);
+	plan->global_generation = os_atomic_load_long(&move_plans_generation);
+	obs_scene_enum_items(obs_scene_from_source(scene_a), add_item, plan);
+	plan->scene_items_a = plan->scene_items.num;
+	plan->item_pos = 0;
+	obs_scene_enum_items(obs_scene_from_source(scene_b), match_item, plan);
+	move_order_merge(plan, &plan->items_a.da);
+	if (!plan->matched_items &&
+	    (plan->matched_scene_a || plan->matched_scene_b)) {
+		size_t n = 0;
+		for (size_t i = 0; i < plan->items_a.num; i++) {
+			struct move_item *item = plan->items_a.array[i];
+			if ((plan->matched_scene_a && item->item_a) ||
+			    (plan->matched_scene_b && item->item_b))
+				continue;
+			plan->items_a.array[n++] = item;
+		}
+		plan->items_a.num = n;
+		if (plan->matched_scene_b) {
+			plan->items_b.num = 0;
+		}
+	}
+	// items only in scene a go after the last item before them that is
+	// also in scene b
+	plan->item_pos = 0;
+	for (size_t i = 0; i < plan->items_a.num; i++) {
+		struct move_item *item = plan->items_a.array[i];
+		if (item->item_a && !item->item_b) {
+			struct move_order_insert *insert =
+				da_push_back_new(plan->inserts);
+			insert->item = item;
+			insert->pos = plan->item_pos;
+		} else if (item->order_index >= plan->item_pos &&
+			   item->order_index < plan->items_b.num) {
+			plan->item_pos = item->order_index + 1;
+		}
+	}
+	move_order_merge(plan, &plan->items_b.da);
+	scene_overrides_build(&plan->overrides_a, scene_a);
+	scene_overrides_build(&plan->overrides_b, scene_b);
+	for (size_t i = 0; i < plan->items_a.num; i++) {
+		struct move_item *item = plan->items_a.array[i];
+		if ((item->item_a && item->item_b) ||
+		    item->move_scene) {
+			item->easing = move->easing_move;
+			item->easing_function =
+				move->easing_function_move;
+			item->transition_scale =
+				move->transition_move_scale;
+			item->curve = move->curve_move;
+		} else if (item->item_b) {
+			item->easing = move->easing_in;
+			item->easing_function =
+				move->easing_function_in;
+			item->position = move->position_in;
+			item->zoom = move->zoom_in;
+			item->curve = move->curve_in;
+		} else if (item->item_a) {
+			item->easing = move->easing_out;
+			item->easing_function =
+				move->easing_function_out;
+			item->position = move->position_out;
+			item->zoom = move->zoom_out;
+			item->curve = move->curve_out;
+		}
+
+		struct move_override *settings_a =
+			get_override_filter_settings(plan, item->item_a);
+		struct move_override *settings_b =
+			get_override_filter_settings(plan, item->item_b);
+		const bool matched = (item->item_a && item->item_b) ||
+				     item->move_scene;
+		if (settings_a && settings_b) {
+			long long val_a = settings_a->easing_match;
+			long long val_b = settings_b->easing_match;
+			if (val_a != NO_OVERRIDE &&
+			    val_b != NO_OVERRIDE) {
+				item->easing = (val_a & EASE_IN) |
+					       (val_b & EASE_OUT);
+			} else if (val_a != NO_OVERRIDE) {
+				item->easing = val_a;
+			} else if (val_b != NO_OVERRIDE) {
+				item->easing = val_b;
+			}
+			val_a = settings_a->easing_function_match;
+			val_b = settings_b->easing_function_match;
+			if (val_a != NO_OVERRIDE) {
+				item->easing_function = val_a;
+			} else if (val_b != NO_OVERRIDE) {
+				item->easing_function = val_b;
+			}
+			if (settings_a->transition_match) {
+				item->transition_name = move_plan_intern(
+					plan, settings_a->transition_match);
+			} else if (settings_b->transition_match) {
+				item->transition_name = move_plan_intern(
+					plan, settings_b->transition_match);
+			}
+			val_a = settings_a->transition_scale;
+			val_b = settings_b->transition_scale;
+			if (val_a != NO_OVERRIDE) {
+				item->transition_scale = val_a;
+			} else if (val_b != NO_OVERRIDE) {
+				item->transition_scale = val_b;
+			}
+			if (settings_a->curve_override_match) {
+				item->curve = settings_a->curve_match;
+			} else if (settings_b->curve_override_match) {
+				item->curve = settings_b->curve_match;
+			}
+
+			val_a = settings_a->start_delay_match_from;
+			val_b = settings_b->start_delay_match_to;
+			if (val_a != NO_OVERRIDE &&
+			    val_b != NO_OVERRIDE) {
+				item->start_percentage =
+					(int)(val_a + val_b) >> 1;
+			} else if (val_a != NO_OVERRIDE) {
+				item->start_percentage = (int)val_a;
+			} else if (val_b != NO_OVERRIDE) {
+				item->start_percentage = (int)val_b;
+			}
+			val_a = settings_a->end_delay_match_from;
+			val_b = settings_b->end_delay_match_to;
+			if (val_a != NO_OVERRIDE &&
+			    val_b != NO_OVERRIDE) {
+				item->end_percentage =
+					100 -
+					((int)(val_a + val_b) >> 1);
+			} else if (val_a != NO_OVERRIDE) {
+				item->end_percentage = 100 - (int)val_a;
+			} else if (val_b != NO_OVERRIDE) {
+				item->end_percentage = 100 - (int)val_b;
+			}
+		} else if (settings_a) {
+			long long val = matched ? settings_a->easing_match
+						: settings_a->easing_out;
+			if (val != NO_OVERRIDE) {
+				item->easing = val;
+			}
+			val = matched ? settings_a->easing_function_match
+				      : settings_a->easing_function_out;
+			if (val != NO_OVERRIDE) {
+				item->easing_function = val;
+			}
+			if (settings_a->zoom_out != NO_OVERRIDE) {
+				item->zoom = !!settings_a->zoom_out;
+			}
+			if (settings_a->position_out != NO_OVERRIDE) {
+				item->position = settings_a->position_out;
+			}
+			if (settings_a->transition_scale != NO_OVERRIDE) {
+				item->transition_scale =
+					settings_a->transition_scale;
+			}
+			if (!item->move_scene && settings_a->transition_out &&
+			    item->item_a && !item->item_b) {
+				item->transition_name = move_plan_intern(
+					plan, settings_a->transition_out);
+			}
+			if (settings_a->transition_match && matched) {
+				item->transition_name = move_plan_intern(
+					plan, settings_a->transition_match);
+			}
+			if (matched && settings_a->curve_override_match) {
+				item->curve = settings_a->curve_match;
+			} else if (!item->move_scene && item->item_a &&
+				   !item->item_b &&
+				   settings_a->curve_override_out) {
+				item->curve = settings_a->curve_out;
+			}
+			val = matched ? settings_a->start_delay_match_from
+				      : settings_a->start_delay_out;
+			if (val != NO_OVERRIDE) {
+				item->start_percentage = (int)val;
+			}
+			val = matched ? settings_a->end_delay_match_from
+				      : settings_a->end_delay_out;
+			if (val != NO_OVERRIDE) {
+				item->end_percentage = 100 - (int)val;
+			}
+		} else if (settings_b) {
+			long long val = matched ? settings_b->easing_match
+						: settings_b->easing_in;
+			if (val != NO_OVERRIDE) {
+				item->easing = val;
+			}
+			val = matched ? settings_b->easing_function_match
+				      : settings_b->easing_function_in;
+			if (val != NO_OVERRIDE) {
+				item->easing_function = val;
+			}
+			if (settings_b->zoom_in != NO_OVERRIDE) {
+				item->zoom = !!settings_b->zoom_in;
+			}
+			if (settings_b->position_in != NO_OVERRIDE) {
+				item->position = settings_b->position_in;
+			}
+			if (settings_b->transition_scale != NO_OVERRIDE) {
+				item->transition_scale =
+					settings_b->transition_scale;
+			}
+			if (!item->move_scene && settings_b->transition_in &&
+			    !item->item_a && item->item_b) {
+				item->transition_name = move_plan_intern(
+					plan, settings_b->transition_in);
+			}
+			if (settings_b->transition_match && matched) {
+				item->transition_name = move_plan_intern(
+					plan, settings_b->transition_match);
+			}
+			if (matched && settings_b->curve_override_match) {
+				item->curve = settings_b->curve_match;
+			} else if (!item->move_scene && !item->item_a &&
+				   item->item_b &&
+				   settings_b->curve_override_in) {
+				item->curve = settings_b->curve_in;
+			}
+			val = matched ? settings_b->start_delay_match_to
+				      : settings_b->start_delay_in;
+			if (val != NO_OVERRIDE) {
+				item->start_percentage = (int)val;
+			}
+			val = matched ? settings_b->end_delay_match_to
+				      : settings_b->end_delay_in;
+			if (val != NO_OVERRIDE) {
+				item->end_percentage = 100 - (int)val;
+			}
+		}
+		move_override_release(settings_a);
+		move_override_release(settings_b);
+		item->ease = get_easing_function(item->easing,
+						 item->easing_function);
+		if (!item->transition_name && !item->move_scene &&
+		    !item->item_a && item->item_b &&
+		    move->transition_in && strlen(move->transition_in))
+			item->transition_name =
+				move_plan_intern(plan, move->transition_in);
+		if (!item->transition_name && !item->move_scene &&
+		    item->item_a && !item->item_b &&
+		    move->transition_out &&
+		    strlen(move->transition_out))
+			item->transition_name =
+				move_plan_intern(plan, move->transition_out);
+		if (!item->transition_name &&
+		    ((item->item_a && item->item_b) ||
+		     item->move_scene) &&
+		    move->transition_move &&
+		    strlen(move->transition_move))
+			item->transition_name =
+				move_plan_intern(plan, move->transition_move);
+	}
+	plan->reusable = scene_a && scene_b && move_items_named(plan);
+	plan->create_ns = os_gettime_ns() - start;
+	plan->create_allocs = bnum_allocs() - allocs;
+	return plan;
+}
+
+static void move_render_item(struct move_info *move, struct move_plan *plan,
+			     struct move_item *item, struct move_stats *stats)
+{
+	const uint64_t start = os_gettime_ns();
+	render2_item(move, &plan->snapshot, &plan->frame, item);
+	const uint64_t ns = os_gettime_ns() - start;
+	stats->items++;
+	stats->item_ns += ns;
+	if (ns > stats->item_ns_max)
+		stats->item_ns_max = ns;
+}
+
+static void move_stats_add_frame(struct move_info *move,
+				 struct move_stats *frame, uint64_t start,
+				 bool first)
+{
+	const uint64_t ns = os_gettime_ns() - start;
+	pthread_mutex_lock(&move->stats_mutex);
+	struct move_stats *stats = &move->stats;
+	if (first) {
+		memset(stats, 0, sizeof(struct move_stats));
+		stats->match_ns = frame->match_ns;
+		stats->match_allocs = frame->match_allocs;
+	}
+	stats->setup_ns += frame->setup_ns;
+	stats->interpolate_ns += frame->interpolate_ns;
+	if (frame->interpolate_ns > stats->interpolate_ns_max)
+		stats->interpolate_ns_max = frame->interpolate_ns;
+	stats->frames++;
+	if (ns > obs_get_frame_interval_ns())
+		stats->slow_frames++;
+	stats->frame_ns += ns;
+	if (ns > stats->frame_ns_max)
+		stats->frame_ns_max = ns;
+	stats->items += frame->items;
+	stats->item_ns += frame->item_ns;
+	if (frame->item_ns_max > stats->item_ns_max)
+		stats->item_ns_max = frame->item_ns_max;
+	stats->offscreen_passes += move->frame_offscreen_passes;
+	pthread_mutex_unlock(&move->stats_mutex);
+	move->frame_offscreen_passes = 0;
+}
+
 static void move_video_render(void *data, gs_effect_t *effect)
 {
 	struct move_info *move = data;
+	const uint64_t frame_start = os_gettime_ns();
+	const bool first = move->start_init;
+	struct move_stats frame = {0};
 
 	move->t = obs_transition_get_time(move->source);
 
-	if (move->start_init) {
-		obs_source_t *old_scene_a = move->scene_source_a;
-		move->scene_source_a = obs_transition_get_source(
+	if (first) {
+		obs_source_t *scene_a = obs_transition_get_source(
 			move->source, OBS_TRANSITION_SOURCE_A);
-		obs_source_t *old_scene_b = move->scene_source_b;
-		move->scene_source_b = obs_transition_get_source(
+		obs_source_t *scene_b = obs_transition_get_source(
 			move->source, OBS_TRANSITION_SOURCE_B);
 
-		obs_source_release(old_scene_a);
-		obs_source_release(old_scene_b);
-
-		clear_items(move, true);
-		move->matched_items = 0;
 		move->transition_pool_move_index = 0;
 		move->transition_pool_in_index = 0;
 		move->transition_pool_out_index = 0;
-		move->matched_scene_a = false;
-		move->matched_scene_b = false;
-		move->item_pos = 0;
-		obs_scene_enum_items(
-			obs_scene_from_source(move->scene_source_a), add_item,
-			data);
-		move->item_pos = 0;
-		obs_scene_enum_items(
-			obs_scene_from_source(move->scene_source_b), match_item,
-			data);
-		if (!move->matched_items &&
-		    (move->matched_scene_a || move->matched_scene_b)) {
-			size_t i = 0;
-			while (i < move->items_a.num) {
-				struct move_item *item = move->items_a.array[i];
-				if (move->matched_scene_a && item->item_a) {
-					da_erase(move->items_a, i);
-				} else if (move->matched_scene_b &&
-					   item->item_b) {
-					da_erase(move->items_a, i);
-				} else {
-					i++;
-				}
-			}
-			if (move->matched_scene_b) {
-				move->items_b.num = 0;
-			}
-		}
-		move->item_pos = 0;
-		for (size_t i = 0; i < move->items_a.num; i++) {
-			struct move_item *item = move->items_a.array[i];
-			if (item->item_a && !item->item_b) {
-				da_insert(move->items_b, move->item_pos, &item);
-				move->item_pos++;
-			} else {
-				for (size_t j = move->item_pos;
-				     j < move->items_b.num; j++) {
-					if (item == move->items_b.array[j]) {
-						move->item_pos = j + 1;
-						break;
-					}
-				}
-			}
-		}
-		for (size_t i = 0; i < move->items_a.num; i++) {
-			struct move_item *item = move->items_a.array[i];
-			if ((item->item_a && item->item_b) ||
-			    item->move_scene) {
-				item->easing = move->easing_move;
-				item->easing_function =
-					move->easing_function_move;
-				item->transition_scale =
-					move->transition_move_scale;
-				item->curve = move->curve_move;
-			} else if (item->item_b) {
-				item->easing = move->easing_in;
-				item->easing_function =
-					move->easing_function_in;
-				item->position = move->position_in;
-				item->zoom = move->zoom_in;
-				item->curve = move->curve_in;
-			} else if (item->item_a) {
-				item->easing = move->easing_out;
-				item->easing_function =
-					move->easing_function_out;
-				item->position = move->position_out;
-				item->zoom = move->zoom_out;
-				item->curve = move->curve_out;
-			}
-
-			obs_data_t *settings_a =
-				get_override_filter_settings(item->item_a);
-			obs_data_t *settings_b =
-				get_override_filter_settings(item->item_b);
-			if (settings_a && settings_b) {
-				long long val_a = obs_data_get_int(
-					settings_a, S_EASING_MATCH);
-				long long val_b = obs_data_get_int(
-					settings_b, S_EASING_MATCH);
-				if (val_a != NO_OVERRIDE &&
-				    val_b != NO_OVERRIDE) {
-					item->easing = (val_a & EASE_IN) |
-						       (val_b & EASE_OUT);
-				} else if (val_a != NO_OVERRIDE) {
-					item->easing = val_a;
-				} else if (val_b != NO_OVERRIDE) {
-					item->easing = val_b;
-				}
-				val_a = obs_data_get_int(
-					settings_a, S_EASING_FUNCTION_MATCH);
-				val_b = obs_data_get_int(
-					settings_b, S_EASING_FUNCTION_MATCH);
-				if (val_a != NO_OVERRIDE) {
-					item->easing_function = val_a;
-				} else if (val_b != NO_OVERRIDE) {
-					item->easing_function = val_b;
-				}
-				const char *cv_a = obs_data_get_string(
-					settings_a, S_TRANSITION_MATCH);
-				const char *cv_b = obs_data_get_string(
-					settings_b, S_TRANSITION_MATCH);
-				if (cv_a && strlen(cv_a)) {
-					item->transition_name = bstrdup(cv_a);
-				} else if (cv_b && strlen(cv_b)) {
-					item->transition_name = bstrdup(cv_b);
-				}
-				val_a = obs_data_get_int(settings_a,
-							 S_TRANSITION_SCALE);
-				val_b = obs_data_get_int(settings_b,
-							 S_TRANSITION_SCALE);
-				if (val_a != NO_OVERRIDE) {
-					item->transition_scale = val_a;
-				} else if (val_b != NO_OVERRIDE) {
-					item->transition_scale = val_b;
-				}
-				if (obs_data_get_bool(settings_a,
-						      S_CURVE_OVERRIDE_MATCH)) {
-					item->curve = (float)obs_data_get_double(
-						settings_a, S_CURVE_MATCH);
-				} else if (obs_data_get_bool(
-						   settings_b,
-						   S_CURVE_OVERRIDE_MATCH)) {
-					item->curve = (float)obs_data_get_double(
-						settings_b, S_CURVE_MATCH);
-				}
 
-				val_a = obs_data_get_int(
-					settings_a, S_START_DELAY_MATCH_FROM);
-				val_b = obs_data_get_int(
-					settings_b, S_START_DELAY_MATCH_TO);
-				if (val_a != NO_OVERRIDE &&
-				    val_b != NO_OVERRIDE) {
-					item->start_percentage =
-						(int)(val_a + val_b) >> 1;
-				} else if (val_a != NO_OVERRIDE) {
-					item->start_percentage = (int)val_a;
-				} else if (val_b != NO_OVERRIDE) {
-					item->start_percentage = (int)val_b;
-				}
-				val_a = obs_data_get_int(
-					settings_a, S_END_DELAY_MATCH_FROM);
-				val_b = obs_data_get_int(settings_b,
-							 S_END_DELAY_MATCH_TO);
-				if (val_a != NO_OVERRIDE &&
-				    val_b != NO_OVERRIDE) {
-					item->end_percentage =
-						100 -
-						((int)(val_a + val_b) >> 1);
-				} else if (val_a != NO_OVERRIDE) {
-					item->end_percentage = 100 - (int)val_a;
-				} else if (val_b != NO_OVERRIDE) {
-					item->end_percentage = 100 - (int)val_b;
-				}
-			} else if (settings_a) {
-				long long val;
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(settings_a,
-							       S_EASING_MATCH);
-				else
-					val = obs_data_get_int(settings_a,
-							       S_EASING_OUT);
-				if (val != NO_OVERRIDE) {
-					item->easing = val;
-				}
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(
-						settings_a,
-						S_EASING_FUNCTION_MATCH);
-				else
-					val = obs_data_get_int(
-						settings_a,
-						S_EASING_FUNCTION_OUT);
-				if (val != NO_OVERRIDE) {
-					item->easing_function = val;
-				}
-				val = obs_data_get_int(settings_a, S_ZOOM_OUT);
-				if (val != NO_OVERRIDE) {
-					item->zoom = !!val;
-				}
-				val = obs_data_get_int(settings_a,
-						       S_POSITION_OUT);
-				if (val != NO_OVERRIDE) {
-					item->position = val;
-				}
-				val = obs_data_get_int(settings_a,
-						       S_TRANSITION_SCALE);
-				if (val != NO_OVERRIDE) {
-					item->transition_scale = val;
-				}
-				const char *ti = obs_data_get_string(
-					settings_a, S_TRANSITION_OUT);
-				if (!item->move_scene && ti && strlen(ti) &&
-				    item->item_a && !item->item_b) {
-					item->transition_name = bstrdup(ti);
-				}
-				const char *tm = obs_data_get_string(
-					settings_a, S_TRANSITION_MATCH);
-				if (tm && strlen(tm) &&
-				    ((item->item_a && item->item_b) ||
-				     item->move_scene)) {
-					item->transition_name = bstrdup(tm);
-				}
-				if (((item->item_a && item->item_b) ||
-				     item->move_scene) &&
-				    obs_data_get_bool(settings_a,
-						      S_CURVE_OVERRIDE_MATCH)) {
-					item->curve = (float)obs_data_get_double(
-						settings_a, S_CURVE_MATCH);
-				} else if (!item->move_scene && item->item_a &&
-					   !item->item_b &&
-					   obs_data_get_bool(
-						   settings_a,
-						   S_CURVE_OVERRIDE_OUT)) {
-					item->curve = (float)obs_data_get_double(
-						settings_a, S_CURVE_OUT);
-				}
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(
-						settings_a,
-						S_START_DELAY_MATCH_FROM);
-				else
-					val = obs_data_get_int(
-						settings_a, S_START_DELAY_OUT);
-				if (val != NO_OVERRIDE) {
-					item->start_percentage = (int)val;
-				}
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(
-						settings_a,
-						S_END_DELAY_MATCH_FROM);
-				else
-					val = obs_data_get_int(settings_a,
-							       S_END_DELAY_OUT);
-				if (val != NO_OVERRIDE) {
-					item->end_percentage = 100 - (int)val;
-				}
-			} else if (settings_b) {
-				long long val;
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(settings_b,
-							       S_EASING_MATCH);
-				else
-					val = obs_data_get_int(settings_b,
-							       S_EASING_IN);
-				if (val != NO_OVERRIDE) {
-					item->easing = val;
-				}
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(
-						settings_b,
-						S_EASING_FUNCTION_MATCH);
-				else
-					val = obs_data_get_int(
-						settings_b,
-						S_EASING_FUNCTION_IN);
-				if (val != NO_OVERRIDE) {
-					item->easing_function = val;
-				}
-				val = obs_data_get_int(settings_b, S_ZOOM_IN);
-				if (val != NO_OVERRIDE) {
-					item->zoom = !!val;
-				}
-				val = obs_data_get_int(settings_b,
-						       S_POSITION_IN);
-				if (val != NO_OVERRIDE) {
-					item->position = val;
-				}
-				val = obs_data_get_int(settings_b,
-						       S_TRANSITION_SCALE);
-				if (val != NO_OVERRIDE) {
-					item->transition_scale = val;
-				}
-				const char *to = obs_data_get_string(
-					settings_b, S_TRANSITION_IN);
-				if (!item->move_scene && to && strlen(to) &&
-				    !item->item_a && item->item_b) {
-					item->transition_name = bstrdup(to);
-				}
-				const char *tm = obs_data_get_string(
-					settings_b, S_TRANSITION_MATCH);
-				if (tm && strlen(tm) &&
-				    ((item->item_a && item->item_b) ||
-				     item->move_scene)) {
-					item->transition_name = bstrdup(tm);
-				}
-				if (((item->item_a && item->item_b) ||
-				     item->move_scene) &&
-				    obs_data_get_bool(settings_b,
-						      S_CURVE_OVERRIDE_MATCH)) {
-					item->curve = (float)obs_data_get_double(
-						settings_b, S_CURVE_MATCH);
-				} else if (!item->move_scene && !item->item_a &&
-					   item->item_b &&
-					   obs_data_get_bool(
-						   settings_b,
-						   S_CURVE_OVERRIDE_IN)) {
-					item->curve =
-						(float)obs_data_get_double(
-							settings_b, S_CURVE_IN);
-				}
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(
-						settings_b,
-						S_START_DELAY_MATCH_TO);
-				else
-					val = obs_data_get_int(
-						settings_b, S_START_DELAY_IN);
-				if (val != NO_OVERRIDE) {
-					item->start_percentage = (int)val;
-				}
-				if ((item->item_a && item->item_b) ||
-				    item->move_scene)
-					val = obs_data_get_int(
-						settings_b,
-						S_END_DELAY_MATCH_TO);
-				else
-					val = obs_data_get_int(settings_b,
-							       S_END_DELAY_IN);
-				if (val != NO_OVERRIDE) {
-					item->end_percentage = 100 - (int)val;
-				}
+		// the plan is normally prepared by the transition_start signal,
+		// only build it here when that did not happen for these scenes
+		struct move_plan *old_plan = NULL;
+		struct move_plan *stale_plan = NULL;
+		pthread_mutex_lock(&move->plan_mutex);
+		if (move_plan_current(move, move->pending_plan, scene_a,
+				      scene_b)) {
+			old_plan = move->plan;
+			move->plan = move->pending_plan;
+		} else {
+			stale_plan = move->pending_plan;
+			// a plan kept from the last run is only reused when
+			// the scenes still have the same items
+			if (!move_plan_valid(move, move->plan, scene_a,
+					     scene_b) ||
+			    (!move->plan->attached &&
+			     !move_plan_attach(move->plan, scene_a, scene_b))) {
+				old_plan = move->plan;
+				move->plan = move_plan_create(move, scene_a,
+							      scene_b);
+				scene_a = NULL;
+				scene_b = NULL;
 			}
-			obs_data_release(settings_a);
-			obs_data_release(settings_b);
-			if (!item->transition_name && !item->move_scene &&
-			    !item->item_a && item->item_b &&
-			    move->transition_in && strlen(move->transition_in))
-				item->transition_name =
-					bstrdup(move->transition_in);
-			if (!item->transition_name && !item->move_scene &&
-			    item->item_a && !item->item_b &&
-			    move->transition_out &&
-			    strlen(move->transition_out))
-				item->transition_name =
-					bstrdup(move->transition_out);
-			if (!item->transition_name &&
-			    ((item->item_a && item->item_b) ||
-			     item->move_scene) &&
-			    move->transition_move &&
-			    strlen(move->transition_move))
-				item->transition_name =
-					bstrdup(move->transition_move);
+		}
+		move->pending_plan = NULL;
+		pthread_mutex_unlock(&move->plan_mutex);
+		obs_source_release(scene_a);
+		obs_source_release(scene_b);
+		move_plan_recycle(move, old_plan, true);
+		move_plan_recycle(move, stale_plan, true);
+		clear_item_transitions(move->plan, true);
+		move_snapshot_capture(move->plan);
+		frame.setup_ns = os_gettime_ns() - frame_start;
+		if (move->plan) {
+			frame.match_ns = move->plan->create_ns;
+			frame.match_allocs = move->plan->create_allocs;
 		}
 	}
 
-	if (move->t > 0.0f && move->t < 1.0f) {
-		if (!move->scene_source_a)
-			move->scene_source_a = obs_transition_get_source(
-				move->source, OBS_TRANSITION_SOURCE_A);
-		if (!move->scene_source_b)
-			move->scene_source_b = obs_transition_get_source(
-				move->source, OBS_TRANSITION_SOURCE_B);
+	struct move_plan *plan = move->plan;
+	if (plan && move->t > 0.0f && move->t < 1.0f) {
+		const uint64_t interpolate_start = os_gettime_ns();
+		move_frame_update(move, plan);
+		frame.interpolate_ns = os_gettime_ns() - interpolate_start;
 
 		gs_matrix_push();
 		gs_blend_state_push();
 		gs_reset_blend_state();
 		if (move->t * 100.0 < move->item_order_switch_percentage) {
-			for (size_t i = 0; i < move->items_a.num; i++) {
-				struct move_item *item = move->items_a.array[i];
-				render2_item(move, item);
+			for (size_t i = 0; i < plan->items_a.num; i++) {
+				struct move_item *item = plan->items_a.array[i];
+				move_render_item(move, plan, item, &frame);
 			}
 		} else {
-			for (size_t i = 0; i < move->items_b.num; i++) {
-				struct move_item *item = move->items_b.array[i];
-				render2_item(move, item);
+			for (size_t i = 0; i < plan->items_b.num; i++) {
+				struct move_item *item = plan->items_b.array[i];
+				move_render_item(move, plan, item, &frame);
 			}
 		}
 		gs_blend_state_pop();
@@ -1984,6 +2206,7 @@ static void move_video_render(void *data, gs_effect_t *effect)
 						   OBS_TRANSITION_SOURCE_B);
 	}
 	move->start_init = false;
+	move_stats_add_frame(move, &frame, frame_start, first);
 
 	UNUSED_PARAMETER(effect);
 }
@@ -2127,6 +2350,9 @@ static obs_properties_t *move_properties(void *data)
 	obs_properties_add_bool(group, S_CACHE_TRANSITIONS,
 				obs_module_text("CacheTransitions"));
 
+	obs_properties_add_bool(group, S_LOG_RENDER_STATS,
+				obs_module_text("LogRenderStats"));
+
 	p = obs_properties_add_int_slider(group, S_SWITCH_PERCENTAGE,
 				      obs_module_text("SwitchPoint"), 0, 100,
 				      1);
@@ -2261,7 +2487,9 @@ static void move_start(void *data)
 static void move_stop(void *data)
 {
 	struct move_info *move = data;
-	clear_items(move, false);
+	move_plan_detach(move->plan, false);
+	if (move->log_render_stats)
+		move_log_render_stats(move);
 }
 
 struct obs_source_info move_transition = {.id = "move_transition",
@@ -2297,6 +2525,10 @@ extern struct obs_source_info move_audio_value_filter;
 
 bool obs_module_load(void)
 {
+	move_rename_init();
+	move_rename_subscribe(NULL, NULL, move_plans_source_rename);
+	move_scheduler_init();
+	move_chains_init();
 	obs_register_source(&move_transition);
 	obs_register_source(&move_transition_override_filter);
 	obs_register_source(&move_source_filter);
@@ -2304,3 +2536,11 @@ bool obs_module_load(void)
 	obs_register_source(&move_audio_value_filter);
 	return true;
 }
+
+void obs_module_unload(void)
+{
+	move_chains_free();
+	move_scheduler_free();
+	move_rename_free();
+	texrender_pool_free();
+}
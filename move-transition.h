@@ -2,6 +2,8 @@
 
 #include <obs-module.h>
 #include <util/darray.h>
+#include <graphics/matrix4.h>
+#include "easing.h"
 
 #define MOVE_SOURCE_FILTER_ID "move_source_filter"
 #define MOVE_VALUE_FILTER_ID "move_value_filter"
@@ -58,6 +60,7 @@
 #define S_TRANSFORM_TEXT "transform_text"
 #define S_SWITCH_PERCENTAGE "switch_percentage"
 #define S_CACHE_TRANSITIONS "cache_transitions"
+#define S_LOG_RENDER_STATS "log_render_stats"
 #define S_START_TRIGGER "start_trigger"
 #define S_START_DELAY "start_delay"
 #define S_END_DELAY "end_delay"
@@ -67,6 +70,7 @@
 #define S_SETTING_NAME "setting_name"
 #define S_SETTING_INT "setting_int"
 #define S_SETTING_FLOAT "setting_float"
+#define S_SETTING_FLOAT_THRESHOLD "setting_float_threshold"
 #define S_SETTING_COLOR "setting_color"
 #define S_VALUE_TYPE "value_type"
 #define S_TRANSFORM_RELATIVE "transform_relative"
@@ -136,6 +140,29 @@
 #define CHANGE_ORDER_START (1 << 2)
 #define CHANGE_ORDER_END (1 << 3)
 
+// next move chain of a filter resolved into direct filter references, the
+// hotkey moves a cursor along it
+struct move_chain_step {
+	obs_weak_source_t *filter;
+	obs_source_t *source;
+	bool value;
+	long long next_move_on;
+};
+
+struct move_chain {
+	DARRAY(struct move_chain_step) steps;
+	long generation;
+	size_t cursor;
+	bool started;
+};
+
+void move_chains_init(void);
+void move_chains_free(void);
+void move_chains_invalidate(void);
+void move_chain_free(struct move_chain *chain);
+void move_chain_hotkey(struct move_chain *chain, obs_source_t *filter,
+		       bool values_only);
+
 struct move_value_info {
 	obs_source_t *source;
 	char *filter_name;
@@ -156,19 +183,296 @@ struct move_value_info {
 
 	long long easing;
 	long long easing_function;
+	AHEasingFunction ease;
 
 	long long int_to;
 	long long int_from;
 
 	double double_to;
+	double double_threshold;
 	double double_from;
 
 	struct vec4 color_to;
 	struct vec4 color_from;
 
 	long long value_type;
-	DARRAY(obs_source_t *) filters_done;
+	struct move_chain chain;
+
+	// resolved when a move starts
+	obs_source_t *target;
+	obs_data_t *target_settings;
+	enum obs_data_number_type target_number_type;
+	// set off the video thread, released by the next tick instead
+	volatile bool filter_removed;
+	volatile bool target_stale;
+
+	long long next_move_on;
+	bool reverse;
+};
+
+struct scene_item_index;
+
+struct move_source_info {
+	obs_source_t *source;
+	char *source_name;
+	char *filter_name;
+	obs_sceneitem_t *scene_item;
+	obs_hotkey_id move_start_hotkey;
+
+	long long easing;
+	long long easing_function;
+	AHEasingFunction ease;
+	float curve;
+
+	struct vec2 pos_from;
+	struct vec2 pos_to;
+	float rot_from;
+	float rot_to;
+	struct vec2 scale_from;
+	struct vec2 scale_to;
+	struct vec2 bounds_from;
+	struct vec2 bounds_to;
+	struct obs_sceneitem_crop crop_from;
+	struct obs_sceneitem_crop crop_to;
+	uint64_t duration;
+	uint64_t start_delay;
+	uint64_t end_delay;
+	bool moving;
+	float running_duration;
+	uint32_t canvas_width;
+	uint32_t canvas_height;
+	uint32_t start_trigger;
+	bool enabled;
+	char *next_move_name;
+	bool relative;
+	struct move_chain chain;
 
 	long long next_move_on;
+	long long change_visibility;
+	bool visibility_toggled;
 	bool reverse;
+
+	long long change_order;
+	int order_position;
+
+	struct scene_item_index *item_index;
 };
+
+void move_transition_plans_invalidate(void);
+
+typedef void (*match_index_enum_cb)(void *param, size_t index, void *data);
+
+struct match_entry {
+	const char *name;
+	size_t len;
+	size_t key_len;
+	void *data;
+	uint64_t settings_hash;
+	bool settings_hashed;
+	bool has_settings;
+};
+
+struct match_map_entry {
+	uint64_t hash;
+	size_t index;
+	size_t next;
+};
+
+struct match_map {
+	DARRAY(size_t) heads;
+	DARRAY(struct match_map_entry) entries;
+	size_t mask;
+};
+
+struct match_suffix {
+	const char *str;
+	size_t len;
+	size_t index;
+};
+
+struct match_index {
+	DARRAY(struct match_entry) entries;
+	DARRAY(size_t) unnamed;
+	struct match_map exact;
+	struct match_map keys;
+	DARRAY(struct match_suffix) suffixes;
+	bool exact_built;
+	bool parts_built;
+	bool part_match;
+	bool number_match;
+	bool last_word_match;
+};
+
+void match_index_init(struct match_index *index);
+void match_index_clear(struct match_index *index);
+void match_index_free(struct match_index *index);
+void match_index_add(struct match_index *index, const char *name, void *data);
+bool match_index_settings_hash(struct match_index *index, size_t i,
+			       obs_source_t *source, uint64_t *hash);
+bool match_settings_hash(obs_source_t *source, uint64_t *hash);
+void match_index_enum_exact(struct match_index *index, const char *name,
+			    match_index_enum_cb cb, void *param);
+void match_index_enum_parts(struct match_index *index, const char *name,
+			    bool part_match, bool number_match,
+			    bool last_word_match, match_index_enum_cb cb,
+			    void *param);
+
+struct move_override {
+	volatile long refs;
+	char *source_name;
+	long long easing_match;
+	long long easing_in;
+	long long easing_out;
+	long long easing_function_match;
+	long long easing_function_in;
+	long long easing_function_out;
+	long long position_in;
+	long long position_out;
+	long long zoom_in;
+	long long zoom_out;
+	long long transition_scale;
+	char *transition_match;
+	char *transition_in;
+	char *transition_out;
+	bool curve_override_match;
+	bool curve_override_in;
+	bool curve_override_out;
+	float curve_match;
+	float curve_in;
+	float curve_out;
+	long long start_delay_match_from;
+	long long start_delay_match_to;
+	long long start_delay_in;
+	long long start_delay_out;
+	long long end_delay_match_from;
+	long long end_delay_match_to;
+	long long end_delay_in;
+	long long end_delay_out;
+};
+
+struct move_override *move_filter_get_override(obs_source_t *filter);
+void move_override_release(struct move_override *override);
+
+// running move filters are ticked from one module wide tick callback, the
+// tick returns false once the filter has nothing left to animate
+typedef bool (*move_animation_tick_cb)(void *data, float seconds);
+
+void move_scheduler_init(void);
+void move_scheduler_free(void);
+void move_animation_queue(obs_source_t *source, void *data,
+			  move_animation_tick_cb tick);
+void move_animation_remove(void *data);
+void move_animation_update(obs_source_t *source);
+
+// one source_rename handler for the module, subscribers get the renames of
+// the name they subscribed to, a NULL name subscribes to every rename
+typedef void (*move_rename_cb)(void *data, const char *prev_name,
+			       const char *new_name);
+
+void move_rename_init(void);
+void move_rename_free(void);
+void move_rename_subscribe(void *data, const char *name, move_rename_cb cb);
+void move_rename_unsubscribe(void *data);
+
+struct move_item {
+	obs_sceneitem_t *item_a;
+	obs_sceneitem_t *item_b;
+	gs_texrender_t *item_render;
+	obs_source_t *transition;
+	long long easing;
+	long long easing_function;
+	AHEasingFunction ease;
+	bool zoom;
+	long long position;
+	const char *transition_name;
+	enum obs_transition_scale_type transition_scale;
+	float curve;
+	bool move_scene;
+	int start_percentage;
+	int end_percentage;
+	size_t snapshot_index;
+	// position in items_b while the draw order is built
+	size_t order_index;
+};
+
+#define SNAPSHOT_A 0
+#define SNAPSHOT_B 1
+#define SNAPSHOT_SIDES 2
+#define SNAPSHOT_FIELDS 16
+
+#define SNAPSHOT_TEXTURE (1 << 0)
+#define SNAPSHOT_NESTED_SCENE (1 << 1)
+
+// scene item state of one side of every item, one array per property
+struct move_snapshot_side {
+	float *pos_x;
+	float *pos_y;
+	float *scale_x;
+	float *scale_y;
+	float *bounds_x;
+	float *bounds_y;
+	float *rot;
+	int *crop_left;
+	int *crop_top;
+	int *crop_right;
+	int *crop_bottom;
+	uint32_t *alignment;
+	uint32_t *bounds_alignment;
+	uint32_t *bounds_type;
+	uint32_t *scale_filter;
+	uint32_t *flags;
+};
+
+struct move_snapshot {
+	size_t num;
+	size_t capacity;
+	float *data;
+	struct move_snapshot_side side[SNAPSHOT_SIDES];
+};
+
+struct move_item_layout {
+	struct matrix4 draw_transform;
+	struct obs_sceneitem_crop crop;
+	struct vec2 output_scale;
+	uint32_t width;
+	uint32_t height;
+	uint32_t original_width;
+	uint32_t original_height;
+};
+
+#define FRAME_FIELDS 17
+
+// per frame values of every item, the interpolated ones are A to B lerps
+struct move_frame {
+	size_t capacity;
+	float *data;
+	float *t;
+	float *ot;
+	float *pos_x;
+	float *pos_y;
+	float *scale_x;
+	float *scale_y;
+	float *bounds_x;
+	float *bounds_y;
+	float *rot;
+	float *crop_left;
+	float *crop_top;
+	float *crop_right;
+	float *crop_bottom;
+	// sources can change size while moving, so these are read every frame
+	uint32_t *source_cx[SNAPSHOT_SIDES];
+	uint32_t *source_cy[SNAPSHOT_SIDES];
+	DARRAY(AHEasingFunction) ease;
+	DARRAY(struct move_item_layout) layouts;
+	// the move as a whole this frame
+	float move_t;
+	bool start_init;
+	uint32_t canvas_width;
+	uint32_t canvas_height;
+};
+
+// the item geometry of a frame only reads the snapshot and the frame, so the
+// layout test can compute it without any scene
+obs_sceneitem_t *move_item_scene_item(float t, struct move_item *item);
+void move_frame_layout(struct move_frame *frame, struct move_snapshot *snapshot,
+		       struct move_item **items, size_t num);
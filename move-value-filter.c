@@ -1,6 +1,43 @@
 #include "move-transition.h"
 #include <obs-module.h>
 #include <util/dstr.h>
+#include <util/threading.h>
+
+bool move_value_tick(void *data, float seconds);
+
+static void
+move_value_target_release(struct move_value_info *move_value)
+{
+	obs_data_release(move_value->target_settings);
+	move_value->target_settings = NULL;
+	move_value->target = NULL;
+	move_value->target_number_type = OBS_DATA_NUM_INVALID;
+}
+
+// the tick may be writing into the target, so it releases the target itself
+static void move_value_target_invalidate(struct move_value_info *move_value)
+{
+	os_atomic_set_bool(&move_value->target_stale, true);
+	move_animation_queue(move_value->source, move_value, move_value_tick);
+}
+
+static void move_value_target_resolve(struct move_value_info *move_value)
+{
+	os_atomic_set_bool(&move_value->target_stale, false);
+	move_value_target_release(move_value);
+	move_value->target =
+		move_value->filter ? move_value->filter
+				   : obs_filter_get_parent(move_value->source);
+	move_value->target_settings =
+		obs_source_get_settings(move_value->target);
+	if (move_value->value_type != MOVE_VALUE_UNKNOWN ||
+	    !move_value->target_settings)
+		return;
+	obs_data_item_t *item = obs_data_item_byname(
+		move_value->target_settings, move_value->setting_name);
+	move_value->target_number_type = obs_data_item_numtype(item);
+	obs_data_item_release(&item);
+}
 
 void move_value_start(struct move_value_info *move_value)
 {
@@ -12,15 +49,15 @@ void move_value_start(struct move_value_info *move_value)
 			move_value->filter = obs_source_get_filter_by_name(
 				parent, move_value->setting_filter_name);
 	}
+	move_value_target_resolve(move_value);
 	if (move_value->reverse) {
 		move_value->running_duration = 0.0f;
 		move_value->moving = true;
+		move_animation_queue(move_value->source, move_value,
+				     move_value_tick);
 		return;
 	}
-	obs_source_t *source =
-		move_value->filter ? move_value->filter
-				   : obs_filter_get_parent(move_value->source);
-	obs_data_t *ss = obs_source_get_settings(source);
+	obs_data_t *ss = move_value->target_settings;
 	if (move_value->value_type == MOVE_VALUE_INT) {
 		move_value->int_from =
 			obs_data_get_int(ss, move_value->setting_name);
@@ -57,11 +94,12 @@ void move_value_start(struct move_value_info *move_value)
 			move_value->moving = true;
 		}
 	}
-	if (!move_value->moving &&
-	    move_value->start_trigger == START_TRIGGER_ENABLE_DISABLE) {
+	if (move_value->moving) {
+		move_animation_queue(move_value->source, move_value,
+				     move_value_tick);
+	} else if (move_value->start_trigger == START_TRIGGER_ENABLE_DISABLE) {
 		obs_source_set_enabled(move_value->source, false);
 	}
-	obs_data_release(ss);
 }
 
 bool move_value_start_button(obs_properties_t *props, obs_property_t *property,
@@ -86,68 +124,18 @@ void move_value_start_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey,
 		move_value_start(move_value);
 		return;
 	}
-	if (!move_value->filters_done.num) {
-		move_value_start(move_value);
-		da_push_back(move_value->filters_done, &move_value->source);
-		return;
-	}
-	obs_source_t *parent = obs_filter_get_parent(move_value->source);
-	if (!parent)
-		return;
-
-	struct move_value_info *filter_data = move_value;
-	size_t i = 0;
-	while (i < move_value->filters_done.num) {
-		if (!filter_data->next_move_name ||
-		    !strlen(filter_data->next_move_name)) {
-			move_value_start(move_value);
-			move_value->filters_done.num = 0;
-			da_push_back(move_value->filters_done,
-				     &move_value->source);
-			return;
-		}
-		obs_source_t *filter = obs_source_get_filter_by_name(
-			parent, filter_data->next_move_name);
-		if (!filter || (strcmp(obs_source_get_unversioned_id(filter),
-				       MOVE_VALUE_FILTER_ID) != 0 &&
-				strcmp(obs_source_get_unversioned_id(filter),
-				       MOVE_AUDIO_VALUE_FILTER_ID) != 0)) {
-			obs_source_release(filter);
-			move_value_start(move_value);
-			move_value->filters_done.num = 0;
-			da_push_back(move_value->filters_done,
-				     &move_value->source);
-			return;
-		}
-		if (filter_data->next_move_on != NEXT_MOVE_ON_HOTKEY) {
-			filter_data = obs_obj_get_data(filter);
-			da_push_back(move_value->filters_done,
-				     &filter_data->source);
-
-		} else {
-			filter_data = obs_obj_get_data(filter);
-		}
-		obs_source_release(filter);
-		i++;
-	}
-	for (i = 0; i < move_value->filters_done.num; i++) {
-		if (move_value->filters_done.array[i] == filter_data->source) {
-			move_value_start(move_value);
-			move_value->filters_done.num = 0;
-			da_push_back(move_value->filters_done,
-				     &move_value->source);
-			return;
-		}
-	}
-	move_value_start(filter_data);
-	da_push_back(move_value->filters_done, &filter_data->source);
+	move_chain_hotkey(&move_value->chain, move_value->source, true);
 	UNUSED_PARAMETER(id);
 	UNUSED_PARAMETER(hotkey);
 }
 
+AHEasingFunction get_easing_function(long long easing,
+				     long long easing_function);
+
 void move_value_update(void *data, obs_data_t *settings)
 {
 	struct move_value_info *move_value = data;
+	move_chains_invalidate();
 	obs_source_t *parent = obs_filter_get_parent(move_value->source);
 
 	const char *filter_name = obs_source_get_name(move_value->source);
@@ -174,6 +162,9 @@ void move_value_update(void *data, obs_data_t *settings)
 	    strcmp(move_value->setting_filter_name, setting_filter_name) != 0) {
 		bfree(move_value->setting_filter_name);
 		move_value->setting_filter_name = bstrdup(setting_filter_name);
+		move_value_target_invalidate(move_value);
+		// the tick must not release the filter replaced here
+		os_atomic_set_bool(&move_value->filter_removed, false);
 		obs_source_release(move_value->filter);
 		move_value->filter = NULL;
 		if (parent)
@@ -189,11 +180,14 @@ void move_value_update(void *data, obs_data_t *settings)
 		bfree(move_value->setting_name);
 
 		move_value->setting_name = bstrdup(setting_name);
+		move_value_target_invalidate(move_value);
 	}
 
 	move_value->value_type = obs_data_get_int(settings, S_VALUE_TYPE);
 	move_value->int_to = obs_data_get_int(settings, S_SETTING_INT);
 	move_value->double_to = obs_data_get_double(settings, S_SETTING_FLOAT);
+	move_value->double_threshold =
+		obs_data_get_double(settings, S_SETTING_FLOAT_THRESHOLD);
 	vec4_from_rgba(&move_value->color_to,
 		       (uint32_t)obs_data_get_int(settings, S_SETTING_COLOR));
 
@@ -203,6 +197,8 @@ void move_value_update(void *data, obs_data_t *settings)
 	move_value->easing = obs_data_get_int(settings, S_EASING_MATCH);
 	move_value->easing_function =
 		obs_data_get_int(settings, S_EASING_FUNCTION_MATCH);
+	move_value->ease = get_easing_function(move_value->easing,
+					       move_value->easing_function);
 	move_value->start_trigger =
 		(uint32_t)obs_data_get_int(settings, S_START_TRIGGER);
 
@@ -215,6 +211,13 @@ void move_value_update(void *data, obs_data_t *settings)
 	move_value->next_move_on = obs_data_get_int(settings, S_NEXT_MOVE_ON);
 }
 
+void move_value_enable(void *data, calldata_t *call_data)
+{
+	struct move_value_info *move_value = data;
+	move_animation_queue(move_value->source, move_value, move_value_tick);
+	UNUSED_PARAMETER(call_data);
+}
+
 static void *move_value_create(obs_data_t *settings, obs_source_t *source)
 {
 	struct move_value_info *move_value =
@@ -222,19 +225,28 @@ static void *move_value_create(obs_data_t *settings, obs_source_t *source)
 	move_value->source = source;
 	move_value->move_start_hotkey = OBS_INVALID_HOTKEY_ID;
 	move_value_update(move_value, settings);
+	signal_handler_connect(obs_source_get_signal_handler(source), "enable",
+			       move_value_enable, move_value);
+	// first tick picks up the initial enabled state
+	move_animation_queue(source, move_value, move_value_tick);
 	return move_value;
 }
 
 static void move_value_destroy(void *data)
 {
 	struct move_value_info *move_value = data;
+	move_animation_remove(move_value);
+	signal_handler_disconnect(obs_source_get_signal_handler(
+					  move_value->source),
+				  "enable", move_value_enable, move_value);
+	move_value_target_release(move_value);
 	obs_source_release(move_value->filter);
 	if (move_value->move_start_hotkey != OBS_INVALID_HOTKEY_ID)
 		obs_hotkey_unregister(move_value->move_start_hotkey);
 	bfree(move_value->filter_name);
 	bfree(move_value->setting_filter_name);
 	bfree(move_value->next_move_name);
-	da_free(move_value->filters_done);
+	move_chain_free(&move_value->chain);
 	bfree(move_value);
 }
 
@@ -314,6 +326,9 @@ bool move_value_filter_changed(void *data, obs_properties_t *props,
 	    strcmp(move_value->setting_filter_name, filter_name) != 0) {
 		bfree(move_value->setting_filter_name);
 		move_value->setting_filter_name = bstrdup(filter_name);
+		move_value_target_invalidate(move_value);
+		// the tick must not release the filter replaced here
+		os_atomic_set_bool(&move_value->filter_removed, false);
 		obs_source_release(move_value->filter);
 		move_value->filter =
 			obs_source_get_filter_by_name(parent, filter_name);
@@ -373,9 +388,12 @@ bool move_value_setting_changed(void *data, obs_properties_t *props,
 	obs_property_t *prop_int = obs_properties_get(props, S_SETTING_INT);
 	obs_property_t *prop_float = obs_properties_get(props, S_SETTING_FLOAT);
 	obs_property_t *prop_color = obs_properties_get(props, S_SETTING_COLOR);
+	obs_property_t *prop_threshold =
+		obs_properties_get(props, S_SETTING_FLOAT_THRESHOLD);
 	obs_property_set_visible(prop_int, false);
 	obs_property_set_visible(prop_float, false);
 	obs_property_set_visible(prop_color, false);
+	obs_property_set_visible(prop_threshold, false);
 	enum obs_property_type prop_type = obs_property_get_type(sp);
 	if (prop_type == OBS_PROPERTY_INT) {
 		obs_property_set_visible(prop_int, true);
@@ -390,6 +408,7 @@ bool move_value_setting_changed(void *data, obs_properties_t *props,
 		obs_data_set_int(settings, S_VALUE_TYPE, MOVE_VALUE_INT);
 	} else if (prop_type == OBS_PROPERTY_FLOAT) {
 		obs_property_set_visible(prop_float, true);
+		obs_property_set_visible(prop_threshold, true);
 		obs_property_float_set_limits(prop_float,
 					      obs_property_float_min(sp),
 					      obs_property_float_max(sp),
@@ -444,6 +463,10 @@ static obs_properties_t *move_value_properties(void *data)
 	p = obs_properties_add_float(ppts, S_SETTING_FLOAT,
 				     obs_module_text("Value"), 0, 0, 0);
 	obs_property_set_visible(p, false);
+	p = obs_properties_add_float(ppts, S_SETTING_FLOAT_THRESHOLD,
+				     obs_module_text("ValueThreshold"), 0.0,
+				     1000000.0, 0.001);
+	obs_property_set_visible(p, false);
 	p = obs_properties_add_color(ppts, S_SETTING_COLOR,
 				     obs_module_text("Value"));
 	obs_property_set_visible(p, false);
@@ -539,25 +562,56 @@ static const char *move_value_get_name(void *type_data)
 	return obs_module_text("MoveValueFilter");
 }
 
-float get_eased(float f, long long easing, long long easing_function);
 void vec2_bezier(struct vec2 *dst, struct vec2 *begin, struct vec2 *control,
 		 struct vec2 *end, const float t);
 
-void move_value_tick(void *data, float seconds)
+// a removed target filter lives on through our ref, so stop writing into it
+static void move_value_parent_filter_remove(void *data, calldata_t *call_data)
 {
 	struct move_value_info *move_value = data;
+	obs_source_t *filter = calldata_ptr(call_data, "filter");
+	if (!filter || filter != move_value->filter)
+		return;
+	os_atomic_set_bool(&move_value->filter_removed, true);
+	move_animation_queue(move_value->source, move_value, move_value_tick);
+}
 
+void move_value_filter_add(void *data, obs_source_t *parent)
+{
+	struct move_value_info *move_value = data;
+	move_chains_invalidate();
+	signal_handler_connect(obs_source_get_signal_handler(parent),
+			       "filter_remove", move_value_parent_filter_remove,
+			       data);
 	if (move_value->move_start_hotkey == OBS_INVALID_HOTKEY_ID &&
-	    move_value->filter_name && strlen(move_value->filter_name)) {
-		obs_source_t *parent =
-			obs_filter_get_parent(move_value->source);
-		if (parent)
-			move_value->move_start_hotkey =
-				obs_hotkey_register_source(
-					parent, move_value->filter_name,
-					move_value->filter_name,
-					move_value_start_hotkey, data);
+	    move_value->filter_name && strlen(move_value->filter_name))
+		move_value->move_start_hotkey = obs_hotkey_register_source(
+			parent, move_value->filter_name,
+			move_value->filter_name, move_value_start_hotkey,
+			data);
+}
+
+void move_value_filter_remove(void *data, obs_source_t *parent)
+{
+	struct move_value_info *move_value = data;
+	move_chains_invalidate();
+	signal_handler_disconnect(obs_source_get_signal_handler(parent),
+				  "filter_remove",
+				  move_value_parent_filter_remove, data);
+	move_value_target_invalidate(move_value);
+}
+
+bool move_value_tick(void *data, float seconds)
+{
+	struct move_value_info *move_value = data;
+	if (os_atomic_set_bool(&move_value->filter_removed, false)) {
+		// the next start looks the filter up by name again
+		move_value_target_release(move_value);
+		obs_source_release(move_value->filter);
+		move_value->filter = NULL;
 	}
+	if (os_atomic_set_bool(&move_value->target_stale, false))
+		move_value_target_release(move_value);
 	const bool enabled = obs_source_enabled(move_value->source);
 	if (move_value->enabled != enabled) {
 		if (enabled &&
@@ -567,29 +621,24 @@ void move_value_tick(void *data, float seconds)
 		move_value->enabled = enabled;
 	}
 	if (!move_value->moving || !enabled)
-		return;
+		return false;
 
-	if (!move_value->duration) {
+	if (!move_value->duration || !move_value->target_settings) {
 		move_value->moving = false;
-		return;
+		return false;
 	}
 	move_value->running_duration += seconds;
 	if (move_value->running_duration * 1000.0f <
 	    (move_value->reverse ? move_value->end_delay
 				 : move_value->start_delay)) {
 		if (move_value->reverse)
-			return;
-		obs_source_t *source =
-			move_value->filter
-				? move_value->filter
-				: obs_filter_get_parent(move_value->source);
-		obs_data_t *ss = obs_source_get_settings(source);
+			return true;
+		obs_data_t *ss = move_value->target_settings;
 		move_value->int_from =
 			obs_data_get_int(ss, move_value->setting_name);
 		move_value->double_from =
 			obs_data_get_double(ss, move_value->setting_name);
-		obs_data_release(ss);
-		return;
+		return true;
 	}
 	if (move_value->running_duration * 1000.0f >=
 	    (float)(move_value->start_delay + move_value->duration +
@@ -606,22 +655,34 @@ void move_value_tick(void *data, float seconds)
 	if (move_value->reverse) {
 		t = 1.0f - t;
 	}
-	t = get_eased(t, move_value->easing, move_value->easing_function);
-
-	obs_source_t *source =
-		move_value->filter ? move_value->filter
-				   : obs_filter_get_parent(move_value->source);
-	obs_data_t *ss = obs_source_get_settings(source);
+	if (move_value->ease)
+		t = move_value->ease(t);
+
+	obs_data_t *ss = move_value->target_settings;
+	// the last frame always writes the exact end value
+	const double threshold =
+		move_value->moving ? move_value->double_threshold : 0.0;
+	bool changed = false;
 	if (move_value->value_type == MOVE_VALUE_INT) {
 		const long long value_int =
 			(long long)((1.0 - t) * (double)move_value->int_from +
 				    t * (double)move_value->int_to);
-		obs_data_set_int(ss, move_value->setting_name, value_int);
+		if (obs_data_get_int(ss, move_value->setting_name) !=
+		    value_int) {
+			obs_data_set_int(ss, move_value->setting_name,
+					 value_int);
+			changed = true;
+		}
 	} else if (move_value->value_type == MOVE_VALUE_FLOAT) {
 		const double value_double =
 			(1.0 - t) * move_value->double_from +
 			t * move_value->double_to;
-		obs_data_set_double(ss, move_value->setting_name, value_double);
+		if (fabs(obs_data_get_double(ss, move_value->setting_name) -
+			 value_double) > threshold) {
+			obs_data_set_double(ss, move_value->setting_name,
+					    value_double);
+			changed = true;
+		}
 	} else if (move_value->value_type == MOVE_VALUE_COLOR) {
 		struct vec4 color;
 		color.w = (1.0f - t) * move_value->color_from.w +
@@ -633,30 +694,35 @@ void move_value_tick(void *data, float seconds)
 		color.z = (1.0f - t) * move_value->color_from.z +
 			  t * move_value->color_to.z;
 		const long long value_int = vec4_to_rgba(&color);
-		obs_data_set_int(ss, move_value->setting_name, value_int);
-	} else {
-		obs_data_item_t *item =
-			obs_data_item_byname(ss, move_value->setting_name);
-		const enum obs_data_number_type item_type =
-			obs_data_item_numtype(item);
-		if (item_type == OBS_DATA_NUM_INT) {
-			const long long value_int =
-				(long long)((1.0 -
-					     t) * (double)move_value->int_from +
-					    t * (double)move_value->int_to);
+		if (obs_data_get_int(ss, move_value->setting_name) !=
+		    value_int) {
 			obs_data_set_int(ss, move_value->setting_name,
 					 value_int);
-		} else if (item_type == OBS_DATA_NUM_DOUBLE) {
-			const double value_double =
-				(1.0 - t) * move_value->double_from +
-				t * move_value->double_to;
+			changed = true;
+		}
+	} else if (move_value->target_number_type == OBS_DATA_NUM_INT) {
+		const long long value_int =
+			(long long)((1.0 - t) * (double)move_value->int_from +
+				    t * (double)move_value->int_to);
+		if (obs_data_get_int(ss, move_value->setting_name) !=
+		    value_int) {
+			obs_data_set_int(ss, move_value->setting_name,
+					 value_int);
+			changed = true;
+		}
+	} else if (move_value->target_number_type == OBS_DATA_NUM_DOUBLE) {
+		const double value_double =
+			(1.0 - t) * move_value->double_from +
+			t * move_value->double_to;
+		if (fabs(obs_data_get_double(ss, move_value->setting_name) -
+			 value_double) > threshold) {
 			obs_data_set_double(ss, move_value->setting_name,
 					    value_double);
+			changed = true;
 		}
-		obs_data_item_release(&item);
 	}
-	obs_data_release(ss);
-	obs_source_update(source, NULL);
+	if (changed)
+		move_animation_update(move_value->target);
 	if (!move_value->moving) {
 		if (move_value->start_trigger == START_TRIGGER_ENABLE_DISABLE &&
 		    (move_value->reverse || !move_value->next_move_name ||
@@ -716,6 +782,7 @@ void move_value_tick(void *data, float seconds)
 			move_value->reverse = !move_value->reverse;
 		}
 	}
+	return move_value->moving;
 }
 
 void move_value_activate(void *data)
@@ -756,7 +823,8 @@ struct obs_source_info move_value_filter = {
 	.get_properties = move_value_properties,
 	.get_defaults = move_value_defaults,
 	.video_render = move_value_video_render,
-	.video_tick = move_value_tick,
+	.filter_add = move_value_filter_add,
+	.filter_remove = move_value_filter_remove,
 	.update = move_value_update,
 	.load = move_value_update,
 	.activate = move_value_activate,
@@ -775,7 +843,8 @@ struct obs_source_info move_audio_value_filter = {
 	.get_properties = move_value_properties,
 	.get_defaults = move_value_defaults,
 	.video_render = move_value_video_render,
-	.video_tick = move_value_tick,
+	.filter_add = move_value_filter_add,
+	.filter_remove = move_value_filter_remove,
 	.update = move_value_update,
 	.load = move_value_update,
 	.activate = move_value_activate,
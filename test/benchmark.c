@@ -0,0 +1,208 @@
+// Times the scene item name matching and the per frame easing and
+// interpolation of the move transition over synthetic scenes of 10 to 10000
+// items, together with the number of allocations each step makes
+// Built with -DMOVE_TRANSITION_BENCHMARK=ON, runs without a running OBS
+#include <stdio.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include "../move-transition.h"
+
+#define BENCHMARK_NAME_SIZE 32
+#define BENCHMARK_FRAMES 120
+
+static const char *benchmark_types[] = {"Camera", "Overlay", "Text",
+					"Browser", "Image"};
+#define BENCHMARK_TYPES (sizeof(benchmark_types) / sizeof(benchmark_types[0]))
+
+struct benchmark_scene {
+	size_t num;
+	char *names;
+	float *pos_x;
+	float *pos_y;
+	float *scale_x;
+	float *scale_y;
+	float *bounds_x;
+	float *bounds_y;
+	float *rot;
+	float *crop;
+};
+
+static inline const char *benchmark_name(struct benchmark_scene *scene,
+					 size_t i)
+{
+	return scene->names + i * BENCHMARK_NAME_SIZE;
+}
+
+// scene b holds the items of scene a in reverse order, every fourth of them
+// with a copy suffix that only the number match finds again
+static void benchmark_scene_init(struct benchmark_scene *scene, size_t num,
+				 bool b)
+{
+	scene->num = num;
+	scene->names = bzalloc(num * BENCHMARK_NAME_SIZE);
+	float **fields[] = {&scene->pos_x,    &scene->pos_y,
+			    &scene->scale_x,  &scene->scale_y,
+			    &scene->bounds_x, &scene->bounds_y,
+			    &scene->rot,      &scene->crop};
+	for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++)
+		*fields[f] = bmalloc(num * sizeof(float));
+
+	for (size_t i = 0; i < num; i++) {
+		const size_t item = b ? num - 1 - i : i;
+		char *name = scene->names + i * BENCHMARK_NAME_SIZE;
+		snprintf(name, BENCHMARK_NAME_SIZE, "%s %zu%s",
+			 benchmark_types[item % BENCHMARK_TYPES], item,
+			 b && item % 4 == 0 ? " (2)" : "");
+		scene->pos_x[i] = (float)(item * 37 % 1920);
+		scene->pos_y[i] = (float)(item * 53 % 1080);
+		scene->scale_x[i] = b ? 0.5f : 1.0f;
+		scene->scale_y[i] = b ? 0.5f : 1.0f;
+		scene->bounds_x[i] = 640.0f;
+		scene->bounds_y[i] = 360.0f;
+		scene->rot[i] = b ? 90.0f : 0.0f;
+		scene->crop[i] = (float)(item % 16);
+	}
+}
+
+static void benchmark_scene_free(struct benchmark_scene *scene)
+{
+	bfree(scene->names);
+	bfree(scene->pos_x);
+	bfree(scene->pos_y);
+	bfree(scene->scale_x);
+	bfree(scene->scale_y);
+	bfree(scene->bounds_x);
+	bfree(scene->bounds_y);
+	bfree(scene->rot);
+	bfree(scene->crop);
+}
+
+struct benchmark_match {
+	size_t found;
+};
+
+static void benchmark_match_cb(void *param, size_t index, void *data)
+{
+	UNUSED_PARAMETER(index);
+	UNUSED_PARAMETER(data);
+	struct benchmark_match *match = param;
+	match->found++;
+}
+
+// same order move_plan_create matches in, exact names first and
+// the part and number match only for the items left over
+static uint64_t benchmark_match(struct benchmark_scene *a,
+				struct benchmark_scene *b, size_t *matched,
+				long *allocs)
+{
+	const long allocs_start = bnum_allocs();
+	const uint64_t start = os_gettime_ns();
+
+	struct match_index index;
+	match_index_init(&index);
+	for (size_t i = 0; i < a->num; i++)
+		match_index_add(&index, benchmark_name(a, i), NULL);
+
+	*matched = 0;
+	for (size_t i = 0; i < b->num; i++) {
+		struct benchmark_match match = {0};
+		match_index_enum_exact(&index, benchmark_name(b, i),
+				       benchmark_match_cb, &match);
+		if (!match.found)
+			match_index_enum_parts(&index, benchmark_name(b, i),
+					       false, true, false,
+					       benchmark_match_cb, &match);
+		if (match.found)
+			(*matched)++;
+	}
+	const uint64_t ns = os_gettime_ns() - start;
+	// bnum_allocs() counts live allocations, so take it before freeing
+	*allocs = bnum_allocs() - allocs_start;
+	match_index_free(&index);
+	return ns;
+}
+
+static inline float benchmark_lerp(float a, float b, float t)
+{
+	return (1.0f - t) * a + t * b;
+}
+
+// the easing and the branch free interpolation every frame of a move does
+static uint64_t benchmark_interpolate(struct benchmark_scene *a,
+				      struct benchmark_scene *b,
+				      struct benchmark_scene *out, float *t,
+				      long *allocs)
+{
+	const long allocs_start = bnum_allocs();
+	const uint64_t start = os_gettime_ns();
+	const size_t num = a->num;
+
+	for (int frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+		const float frame_t = (float)frame / (BENCHMARK_FRAMES - 1);
+		for (size_t i = 0; i < num; i++)
+			t[i] = frame_t;
+		EaseBatch(CubicEaseInOut, t, t, num);
+		for (size_t i = 0; i < num; i++) {
+			const float f = t[i];
+			out->pos_x[i] = benchmark_lerp(a->pos_x[i], b->pos_x[i],
+						       f);
+			out->pos_y[i] = benchmark_lerp(a->pos_y[i], b->pos_y[i],
+						       f);
+			out->scale_x[i] = benchmark_lerp(a->scale_x[i],
+							 b->scale_x[i], f);
+			out->scale_y[i] = benchmark_lerp(a->scale_y[i],
+							 b->scale_y[i], f);
+			out->bounds_x[i] = benchmark_lerp(a->bounds_x[i],
+							  b->bounds_x[i], f);
+			out->bounds_y[i] = benchmark_lerp(a->bounds_y[i],
+							  b->bounds_y[i], f);
+			out->rot[i] = benchmark_lerp(a->rot[i], b->rot[i], f);
+			out->crop[i] = benchmark_lerp(a->crop[i], b->crop[i],
+						      f > 1.0f   ? 1.0f
+						      : f < 0.0f ? 0.0f
+								 : f);
+		}
+	}
+
+	const uint64_t ns = os_gettime_ns() - start;
+	*allocs = bnum_allocs() - allocs_start;
+	return ns / BENCHMARK_FRAMES;
+}
+
+int main(void)
+{
+	static const size_t sizes[] = {10, 100, 1000, 10000};
+	float sink = 0.0f;
+
+	printf("%8s %14s %10s %14s %16s %10s\n", "items", "match ns",
+	       "matched", "match allocs", "frame ns", "allocs");
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		const size_t num = sizes[s];
+		struct benchmark_scene a;
+		struct benchmark_scene b;
+		struct benchmark_scene out;
+		benchmark_scene_init(&a, num, false);
+		benchmark_scene_init(&b, num, true);
+		benchmark_scene_init(&out, num, false);
+		float *t = bmalloc(num * sizeof(float));
+
+		size_t matched;
+		long match_allocs;
+		long frame_allocs;
+		const uint64_t match_ns =
+			benchmark_match(&a, &b, &matched, &match_allocs);
+		const uint64_t frame_ns =
+			benchmark_interpolate(&a, &b, &out, t, &frame_allocs);
+		sink += out.pos_x[num - 1];
+
+		printf("%8zu %14llu %10zu %14ld %16llu %10ld\n", num,
+		       (unsigned long long)match_ns, matched, match_allocs,
+		       (unsigned long long)frame_ns, frame_allocs);
+
+		bfree(t);
+		benchmark_scene_free(&a);
+		benchmark_scene_free(&b);
+		benchmark_scene_free(&out);
+	}
+	return sink < 0.0f ? 1 : 0;
+}
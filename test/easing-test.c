@@ -0,0 +1,223 @@
+// Sweeps t over [0, 1] for every single precision easing curve and checks
+// the maximum absolute error against a double precision reference
+// Built with -DMOVE_TRANSITION_TESTS=ON and run through ctest
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "../easing.h"
+
+#define EASING_TEST_SAMPLES (1 << 20)
+
+static double ref_cubic_in_out(double p)
+{
+	if (p < 0.5)
+		return 4 * p * p * p;
+	double f = ((2 * p) - 2);
+	return 0.5 * f * f * f + 1;
+}
+
+static double ref_quintic_in_out(double p)
+{
+	if (p < 0.5)
+		return 16 * p * p * p * p * p;
+	double f = ((2 * p) - 2);
+	return 0.5 * f * f * f * f * f + 1;
+}
+
+static double ref_sine_in(double p)
+{
+	return sin((p - 1) * M_PI_2) + 1;
+}
+
+static double ref_sine_out(double p)
+{
+	return sin(p * M_PI_2);
+}
+
+static double ref_sine_in_out(double p)
+{
+	return 0.5 * (1 - cos(p * M_PI));
+}
+
+static double ref_circular_in(double p)
+{
+	return 1 - sqrt(1 - (p * p));
+}
+
+static double ref_circular_out(double p)
+{
+	return sqrt((2 - p) * p);
+}
+
+static double ref_circular_in_out(double p)
+{
+	if (p < 0.5)
+		return 0.5 * (1 - sqrt(1 - 4 * (p * p)));
+	return 0.5 * (sqrt(-((2 * p) - 3) * ((2 * p) - 1)) + 1);
+}
+
+static double ref_exponential_in(double p)
+{
+	return (p == 0.0) ? p : pow(2, 10 * (p - 1));
+}
+
+static double ref_exponential_out(double p)
+{
+	return (p == 1.0) ? p : 1 - pow(2, -10 * p);
+}
+
+static double ref_exponential_in_out(double p)
+{
+	if (p == 0.0 || p == 1.0)
+		return p;
+	if (p < 0.5)
+		return 0.5 * pow(2, (20 * p) - 10);
+	return -0.5 * pow(2, (-20 * p) + 10) + 1;
+}
+
+static double ref_elastic_in(double p)
+{
+	return sin(13 * M_PI_2 * p) * pow(2, 10 * (p - 1));
+}
+
+static double ref_elastic_out(double p)
+{
+	return sin(-13 * M_PI_2 * (p + 1)) * pow(2, -10 * p) + 1;
+}
+
+static double ref_elastic_in_out(double p)
+{
+	if (p < 0.5)
+		return 0.5 * sin(13 * M_PI_2 * (2 * p)) *
+		       pow(2, 10 * ((2 * p) - 1));
+	return 0.5 * (sin(-13 * M_PI_2 * ((2 * p - 1) + 1)) *
+			      pow(2, -10 * (2 * p - 1)) +
+		      2);
+}
+
+static double ref_back_in(double p)
+{
+	return p * p * p - p * sin(p * M_PI);
+}
+
+static double ref_back_out(double p)
+{
+	double f = (1 - p);
+	return 1 - (f * f * f - f * sin(f * M_PI));
+}
+
+static double ref_back_in_out(double p)
+{
+	if (p < 0.5) {
+		double f = 2 * p;
+		return 0.5 * (f * f * f - f * sin(f * M_PI));
+	}
+	double f = (1 - (2 * p - 1));
+	return 0.5 * (1 - (f * f * f - f * sin(f * M_PI))) + 0.5;
+}
+
+static double ref_bounce_out(double p)
+{
+	if (p < 4 / 11.0)
+		return (121 * p * p) / 16.0;
+	if (p < 8 / 11.0)
+		return (363 / 40.0 * p * p) - (99 / 10.0 * p) + 17 / 5.0;
+	if (p < 9 / 10.0)
+		return (4356 / 361.0 * p * p) - (35442 / 1805.0 * p) +
+		       16061 / 1805.0;
+	return (54 / 5.0 * p * p) - (513 / 25.0 * p) + 268 / 25.0;
+}
+
+static double ref_bounce_in(double p)
+{
+	return 1 - ref_bounce_out(1 - p);
+}
+
+static double ref_bounce_in_out(double p)
+{
+	if (p < 0.5)
+		return 0.5 * ref_bounce_in(p * 2);
+	return 0.5 * ref_bounce_out(p * 2 - 1) + 0.5;
+}
+
+struct easing_test {
+	const char *name;
+	AHEasingFunction function;
+	double (*reference)(double);
+	double max_error;
+};
+
+#define EASING_TEST(f, r, e) {#f, f, r, e}
+
+static const struct easing_test easing_tests[] = {
+	EASING_TEST(CubicEaseInOut, ref_cubic_in_out, 2.5e-7),
+	EASING_TEST(QuinticEaseInOut, ref_quintic_in_out, 2.5e-7),
+	EASING_TEST(SineEaseIn, ref_sine_in, 2.5e-7),
+	EASING_TEST(SineEaseOut, ref_sine_out, 2.5e-7),
+	EASING_TEST(SineEaseInOut, ref_sine_in_out, 2.5e-7),
+	// 1 - sqrt(1 - p^2) cancels in single precision as p gets close to 1
+	EASING_TEST(CircularEaseIn, ref_circular_in, 1e-6),
+	EASING_TEST(CircularEaseOut, ref_circular_out, 2.5e-7),
+	EASING_TEST(CircularEaseInOut, ref_circular_in_out, 5e-7),
+	EASING_TEST(ExponentialEaseIn, ref_exponential_in, 2.5e-7),
+	EASING_TEST(ExponentialEaseOut, ref_exponential_out, 2.5e-7),
+	EASING_TEST(ExponentialEaseInOut, ref_exponential_in_out, 2.5e-7),
+	EASING_TEST(ElasticEaseIn, ref_elastic_in, 5e-7),
+	EASING_TEST(ElasticEaseOut, ref_elastic_out, 5e-7),
+	EASING_TEST(ElasticEaseInOut, ref_elastic_in_out, 5e-7),
+	EASING_TEST(BackEaseIn, ref_back_in, 4e-7),
+	EASING_TEST(BackEaseOut, ref_back_out, 4e-7),
+	EASING_TEST(BackEaseInOut, ref_back_in_out, 4e-7),
+	EASING_TEST(BounceEaseIn, ref_bounce_in, 2.5e-7),
+	EASING_TEST(BounceEaseOut, ref_bounce_out, 2.5e-7),
+	EASING_TEST(BounceEaseInOut, ref_bounce_in_out, 2.5e-7),
+};
+
+static AHFloat easing_test_t[EASING_TEST_SAMPLES + 1];
+static AHFloat easing_test_batch[EASING_TEST_SAMPLES + 1];
+
+static double easing_test_error(double value, double t,
+				const struct easing_test *test,
+				double *max_error, double *max_error_t)
+{
+	const double error = fabs(value - test->reference(t));
+	if (error > *max_error) {
+		*max_error = error;
+		*max_error_t = t;
+	}
+	return error;
+}
+
+// checks the scalar curve and EaseBatch() easing the same values in place
+int main(void)
+{
+	int failed = 0;
+	for (int s = 0; s <= EASING_TEST_SAMPLES; s++)
+		easing_test_t[s] = (AHFloat)s / EASING_TEST_SAMPLES;
+
+	for (size_t i = 0; i < sizeof(easing_tests) / sizeof(easing_tests[0]);
+	     i++) {
+		const struct easing_test *test = &easing_tests[i];
+		memcpy(easing_test_batch, easing_test_t,
+		       sizeof(easing_test_batch));
+		EaseBatch(test->function, easing_test_batch, easing_test_batch,
+			  EASING_TEST_SAMPLES + 1);
+
+		double max_error = 0.0;
+		double max_error_t = 0.0;
+		for (int s = 0; s <= EASING_TEST_SAMPLES; s++) {
+			const double t = easing_test_t[s];
+			easing_test_error(test->function(easing_test_t[s]), t,
+					  test, &max_error, &max_error_t);
+			easing_test_error(easing_test_batch[s], t, test,
+					  &max_error, &max_error_t);
+		}
+		const int ok = max_error <= test->max_error;
+		printf("%-22s max error %.3g at t=%.6f (limit %.3g) %s\n",
+		       test->name, max_error, max_error_t, test->max_error,
+		       ok ? "ok" : "FAILED");
+		if (!ok)
+			failed++;
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,402 @@
+// Computes the draw transform, crop and size of every item of a synthetic
+// corpus of scene pairs at a set of t samples and compares them with the
+// golden file, covering every alignment, bounds type, zoom and position
+// Built with -DMOVE_TRANSITION_TESTS=ON and run through ctest, pass --update
+// after an intended change to write the golden file again
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../move-transition.h"
+
+#define LAYOUT_TEST_CANVAS_CX 1920
+#define LAYOUT_TEST_CANVAS_CY 1080
+#define LAYOUT_TEST_MAX_ITEMS 1024
+#define LAYOUT_TEST_LINE 512
+#define LAYOUT_TEST_MAX_ERRORS 20
+
+static const uint32_t layout_test_alignments[] = {
+	OBS_ALIGN_CENTER,
+	OBS_ALIGN_LEFT,
+	OBS_ALIGN_RIGHT,
+	OBS_ALIGN_TOP,
+	OBS_ALIGN_BOTTOM,
+	OBS_ALIGN_TOP | OBS_ALIGN_LEFT,
+	OBS_ALIGN_TOP | OBS_ALIGN_RIGHT,
+	OBS_ALIGN_BOTTOM | OBS_ALIGN_LEFT,
+	OBS_ALIGN_BOTTOM | OBS_ALIGN_RIGHT,
+};
+#define LAYOUT_TEST_ALIGNMENTS \
+	(sizeof(layout_test_alignments) / sizeof(layout_test_alignments[0]))
+
+static const uint32_t layout_test_bounds_types[] = {
+	OBS_BOUNDS_NONE,           OBS_BOUNDS_STRETCH,
+	OBS_BOUNDS_SCALE_INNER,    OBS_BOUNDS_SCALE_OUTER,
+	OBS_BOUNDS_SCALE_TO_WIDTH, OBS_BOUNDS_SCALE_TO_HEIGHT,
+	OBS_BOUNDS_MAX_ONLY,
+};
+#define LAYOUT_TEST_BOUNDS_TYPES \
+	(sizeof(layout_test_bounds_types) / sizeof(layout_test_bounds_types[0]))
+
+// the positions the transition properties offer for moving in and out
+static const long long layout_test_positions[] = {
+	POS_NONE,
+	POS_CENTER,
+	POS_EDGE,
+	POS_EDGE | POS_TOP | POS_LEFT,
+	POS_EDGE | POS_TOP,
+	POS_EDGE | POS_TOP | POS_RIGHT,
+	POS_EDGE | POS_RIGHT,
+	POS_EDGE | POS_BOTTOM | POS_RIGHT,
+	POS_EDGE | POS_BOTTOM,
+	POS_EDGE | POS_BOTTOM | POS_LEFT,
+	POS_EDGE | POS_LEFT,
+	POS_SWIPE | POS_LEFT,
+	POS_SWIPE | POS_TOP,
+	POS_SWIPE | POS_RIGHT,
+	POS_SWIPE | POS_BOTTOM,
+};
+#define LAYOUT_TEST_POSITIONS \
+	(sizeof(layout_test_positions) / sizeof(layout_test_positions[0]))
+
+static const float layout_test_t[] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+#define LAYOUT_TEST_T (sizeof(layout_test_t) / sizeof(layout_test_t[0]))
+
+// the layout only compares the scene item pointers of an item
+static char layout_test_scene_items[SNAPSHOT_SIDES];
+#define LAYOUT_TEST_ITEM_A ((obs_sceneitem_t *)&layout_test_scene_items[0])
+#define LAYOUT_TEST_ITEM_B ((obs_sceneitem_t *)&layout_test_scene_items[1])
+
+struct layout_test {
+	struct move_snapshot snapshot;
+	struct move_frame frame;
+	struct move_item items[LAYOUT_TEST_MAX_ITEMS];
+	struct move_item *item_list[LAYOUT_TEST_MAX_ITEMS];
+	char labels[LAYOUT_TEST_MAX_ITEMS][64];
+	AHEasingFunction ease[LAYOUT_TEST_MAX_ITEMS];
+};
+
+static void *layout_test_field(float **data, size_t num)
+{
+	void *field = *data;
+	*data += num;
+	return field;
+}
+
+static void layout_test_init(struct layout_test *test)
+{
+	const size_t num = LAYOUT_TEST_MAX_ITEMS;
+	memset(test, 0, sizeof(struct layout_test));
+
+	struct move_snapshot *snapshot = &test->snapshot;
+	snapshot->data = calloc(num * SNAPSHOT_FIELDS * SNAPSHOT_SIDES,
+				sizeof(float));
+	float *data = snapshot->data;
+	for (size_t s = 0; s < SNAPSHOT_SIDES; s++) {
+		struct move_snapshot_side *side = &snapshot->side[s];
+		side->pos_x = layout_test_field(&data, num);
+		side->pos_y = layout_test_field(&data, num);
+		side->scale_x = layout_test_field(&data, num);
+		side->scale_y = layout_test_field(&data, num);
+		side->bounds_x = layout_test_field(&data, num);
+		side->bounds_y = layout_test_field(&data, num);
+		side->rot = layout_test_field(&data, num);
+		side->crop_left = layout_test_field(&data, num);
+		side->crop_top = layout_test_field(&data, num);
+		side->crop_right = layout_test_field(&data, num);
+		side->crop_bottom = layout_test_field(&data, num);
+		side->alignment = layout_test_field(&data, num);
+		side->bounds_alignment = layout_test_field(&data, num);
+		side->bounds_type = layout_test_field(&data, num);
+		side->scale_filter = layout_test_field(&data, num);
+		side->flags = layout_test_field(&data, num);
+	}
+	snapshot->capacity = num;
+
+	struct move_frame *frame = &test->frame;
+	frame->data = calloc(num * FRAME_FIELDS, sizeof(float));
+	data = frame->data;
+	frame->t = layout_test_field(&data, num);
+	frame->ot = layout_test_field(&data, num);
+	frame->pos_x = layout_test_field(&data, num);
+	frame->pos_y = layout_test_field(&data, num);
+	frame->scale_x = layout_test_field(&data, num);
+	frame->scale_y = layout_test_field(&data, num);
+	frame->bounds_x = layout_test_field(&data, num);
+	frame->bounds_y = layout_test_field(&data, num);
+	frame->rot = layout_test_field(&data, num);
+	frame->crop_left = layout_test_field(&data, num);
+	frame->crop_top = layout_test_field(&data, num);
+	frame->crop_right = layout_test_field(&data, num);
+	frame->crop_bottom = layout_test_field(&data, num);
+	for (size_t s = 0; s < SNAPSHOT_SIDES; s++) {
+		frame->source_cx[s] = layout_test_field(&data, num);
+		frame->source_cy[s] = layout_test_field(&data, num);
+	}
+	frame->capacity = num;
+	frame->canvas_width = LAYOUT_TEST_CANVAS_CX;
+	frame->canvas_height = LAYOUT_TEST_CANVAS_CY;
+	da_resize(frame->ease, num);
+	da_resize(frame->layouts, num);
+}
+
+static void layout_test_free(struct layout_test *test)
+{
+	free(test->snapshot.data);
+	free(test->frame.data);
+	da_free(test->frame.ease);
+	da_free(test->frame.layouts);
+}
+
+// the side of an item that is missing stays zero like a captured one, every
+// present side gets its own size, position, scale, rotation and crop derived
+// from the item index so that no two items share a layout
+static void layout_test_side(struct layout_test *test, size_t s, size_t i,
+			     uint32_t alignment, uint32_t bounds_type,
+			     uint32_t bounds_alignment)
+{
+	struct move_snapshot_side *side = &test->snapshot.side[s];
+	struct move_frame *frame = &test->frame;
+	const size_t v = i * 7 + s * 3;
+	frame->source_cx[s][i] = 320 + (uint32_t)(v % 5) * 160;
+	frame->source_cy[s][i] = 180 + (uint32_t)(v % 4) * 90;
+	side->pos_x[i] = (float)(v * 97 % LAYOUT_TEST_CANVAS_CX);
+	side->pos_y[i] = (float)(v * 61 % LAYOUT_TEST_CANVAS_CY);
+	side->scale_x[i] = 0.5f + (float)(v % 3) * 0.25f;
+	side->scale_y[i] = 0.5f + (float)(v % 5) * 0.25f;
+	side->bounds_x[i] = 400.0f + (float)(v % 3) * 240.0f;
+	side->bounds_y[i] = 300.0f + (float)(v % 2) * 150.0f;
+	side->rot[i] = (float)(v % 4) * 30.0f;
+	side->crop_left[i] = (int)(v % 3) * 8;
+	side->crop_top[i] = (int)(v % 2) * 16;
+	side->crop_right[i] = (int)(v % 4) * 4;
+	side->crop_bottom[i] = 0;
+	side->alignment[i] = alignment;
+	side->bounds_type[i] = bounds_type;
+	side->bounds_alignment[i] = bounds_alignment;
+}
+
+static struct move_item *layout_test_add(struct layout_test *test, bool a,
+					 bool b, const char *label)
+{
+	const size_t i = test->snapshot.num++;
+	struct move_item *item = &test->items[i];
+	item->item_a = a ? LAYOUT_TEST_ITEM_A : NULL;
+	item->item_b = b ? LAYOUT_TEST_ITEM_B : NULL;
+	item->snapshot_index = i;
+	test->item_list[i] = item;
+	// runs of curves and linear items as move_frame_ease() sees them
+	test->ease[i] = (i / 3) % 2 ? CubicEaseInOut : NULL;
+	snprintf(test->labels[i], sizeof(test->labels[i]), "%s", label);
+	return item;
+}
+
+// an item that only one of the scenes has
+static struct move_item *layout_test_add_side(struct layout_test *test,
+					      bool out, uint32_t alignment,
+					      uint32_t bounds_type,
+					      const char *label)
+{
+	struct move_item *item = layout_test_add(test, out, !out, label);
+	layout_test_side(test, out ? SNAPSHOT_A : SNAPSHOT_B,
+			 item->snapshot_index, alignment, bounds_type,
+			 OBS_ALIGN_BOTTOM | OBS_ALIGN_RIGHT);
+	return item;
+}
+
+static void layout_test_corpus(struct layout_test *test)
+{
+	char label[64];
+
+	// matched items between every pair of alignments
+	for (size_t a = 0; a < LAYOUT_TEST_ALIGNMENTS; a++) {
+		for (size_t b = 0; b < LAYOUT_TEST_ALIGNMENTS; b++) {
+			snprintf(label, sizeof(label), "move align %zu %zu", a,
+				 b);
+			struct move_item *item =
+				layout_test_add(test, true, true, label);
+			item->curve = (a + b) % 3 ? 0.0f : 0.5f;
+			layout_test_side(test, SNAPSHOT_A,
+					 item->snapshot_index,
+					 layout_test_alignments[a],
+					 OBS_BOUNDS_NONE, OBS_ALIGN_CENTER);
+			layout_test_side(test, SNAPSHOT_B,
+					 item->snapshot_index,
+					 layout_test_alignments[b],
+					 OBS_BOUNDS_NONE, OBS_ALIGN_CENTER);
+		}
+	}
+
+	// matched items between every pair of bounds types, with the bounds
+	// alignment changing as well
+	for (size_t a = 0; a < LAYOUT_TEST_BOUNDS_TYPES; a++) {
+		for (size_t b = 0; b < LAYOUT_TEST_BOUNDS_TYPES; b++) {
+			snprintf(label, sizeof(label), "move bounds %zu %zu",
+				 a, b);
+			struct move_item *item =
+				layout_test_add(test, true, true, label);
+			const uint32_t alignment =
+				layout_test_alignments[(a + b) %
+						       LAYOUT_TEST_ALIGNMENTS];
+			layout_test_side(test, SNAPSHOT_A,
+					 item->snapshot_index, alignment,
+					 layout_test_bounds_types[a],
+					 layout_test_alignments[a]);
+			layout_test_side(test, SNAPSHOT_B,
+					 item->snapshot_index, alignment,
+					 layout_test_bounds_types[b],
+					 layout_test_alignments[b + 2]);
+		}
+	}
+
+	// items moving in and out for every position, zoom and alignment
+	for (size_t out = 0; out < 2; out++) {
+		for (size_t p = 0; p < LAYOUT_TEST_POSITIONS; p++) {
+			for (size_t z = 0; z < 2; z++) {
+				for (size_t a = 0; a < LAYOUT_TEST_ALIGNMENTS;
+				     a++) {
+					const size_t bt =
+						(p + z + a) %
+						LAYOUT_TEST_BOUNDS_TYPES;
+					snprintf(label, sizeof(label),
+						 "%s pos %zu zoom %zu align %zu"
+						 " bounds %zu",
+						 out ? "out" : "in", p, z, a,
+						 bt);
+					struct move_item *item =
+						layout_test_add_side(
+							test, out,
+							layout_test_alignments
+								[a],
+							layout_test_bounds_types
+								[bt],
+							label);
+					item->position =
+						layout_test_positions[p];
+					item->zoom = z;
+				}
+			}
+		}
+	}
+
+	// nested scenes growing out of and shrinking into the canvas
+	for (size_t out = 0; out < 2; out++) {
+		for (size_t bt = 0; bt < 2; bt++) {
+			for (size_t a = 0; a < LAYOUT_TEST_ALIGNMENTS; a++) {
+				snprintf(label, sizeof(label),
+					 "scene %s align %zu bounds %zu",
+					 out ? "out" : "in", a, bt);
+				struct move_item *item = layout_test_add_side(
+					test, out, layout_test_alignments[a],
+					layout_test_bounds_types[bt], label);
+				item->move_scene = true;
+			}
+		}
+	}
+}
+
+// the draw transform only rotates around z, so the 2d part of the matrix is
+// all of it that can change
+static void layout_test_format(char *line, size_t size, const char *label,
+			       float t, const struct move_item_layout *layout)
+{
+	const struct matrix4 *m = &layout->draw_transform;
+	snprintf(line, size,
+		 "%s t %.2f: %.7g %.7g %.7g %.7g %.7g %.7g crop %d %d %d %d"
+		 " scale %.7g %.7g size %u %u %u %u",
+		 label, t, m->x.x, m->x.y, m->y.x, m->y.y, m->t.x, m->t.y,
+		 layout->crop.left, layout->crop.top, layout->crop.right,
+		 layout->crop.bottom, layout->output_scale.x,
+		 layout->output_scale.y, layout->width, layout->height,
+		 layout->original_width, layout->original_height);
+}
+
+// numbers may differ by rounding only, everything else has to be equal
+static bool layout_test_line_equal(const char *line, const char *golden)
+{
+	while (*line && *golden) {
+		char *line_end;
+		char *golden_end;
+		const double a = strtod(line, &line_end);
+		const double b = strtod(golden, &golden_end);
+		if (line_end != line && golden_end != golden) {
+			if (fabs(a - b) > 1e-3 + 1e-5 * fabs(b))
+				return false;
+			line = line_end;
+			golden = golden_end;
+		} else if (*line++ != *golden++) {
+			return false;
+		}
+	}
+	return *line == *golden;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <golden file> [--update]\n",
+			argv[0]);
+		return 2;
+	}
+	const bool update = argc > 2 && strcmp(argv[2], "--update") == 0;
+	FILE *file = fopen(argv[1], update ? "wb" : "rb");
+	if (!file) {
+		fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 2;
+	}
+
+	struct layout_test *test = malloc(sizeof(struct layout_test));
+	layout_test_init(test);
+	layout_test_corpus(test);
+
+	struct move_frame *frame = &test->frame;
+	const size_t num = test->snapshot.num;
+	size_t lines = 0;
+	size_t errors = 0;
+	char line[LAYOUT_TEST_LINE];
+	char golden[LAYOUT_TEST_LINE];
+	for (size_t s = 0; s < LAYOUT_TEST_T; s++) {
+		const float t = layout_test_t[s];
+		frame->move_t = t;
+		for (size_t i = 0; i < num; i++) {
+			frame->t[i] = t;
+			frame->ease.array[i] = test->ease[i];
+		}
+		move_frame_layout(frame, &test->snapshot, test->item_list,
+				  num);
+
+		for (size_t i = 0; i < num; i++) {
+			layout_test_format(line, sizeof(line), test->labels[i],
+					   t, &frame->layouts.array[i]);
+			lines++;
+			if (update) {
+				fprintf(file, "%s\n", line);
+				continue;
+			}
+			// the golden file may have been checked out with crlf
+			if (!fgets(golden, sizeof(golden), file))
+				golden[0] = 0;
+			golden[strcspn(golden, "\r\n")] = 0;
+			if (layout_test_line_equal(line, golden))
+				continue;
+			if (errors++ < LAYOUT_TEST_MAX_ERRORS)
+				printf("expected %s\ngot      %s\n",
+				       golden[0] ? golden : "end of file",
+				       line);
+		}
+	}
+	if (!update && fgets(golden, sizeof(golden), file)) {
+		printf("golden file has more than %zu lines\n", lines);
+		errors++;
+	}
+	fclose(file);
+	layout_test_free(test);
+	free(test);
+
+	if (update)
+		printf("wrote %zu layouts to %s\n", lines, argv[1]);
+	else
+		printf("%zu layouts, %zu differ from %s\n", lines, errors,
+		       argv[1]);
+	return errors ? 1 : 0;
+}